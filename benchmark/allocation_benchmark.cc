@@ -0,0 +1,159 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  benchmark/allocation_benchmark.cc
+ *  @brief Count the heap allocations made when reading a 20000-cue SSA file and collecting
+ *  it, either into a std::list of Subtitles or into a FlatDocument, and time how long
+ *  it takes to throw each result away.
+ *
+ *  Allocations are counted by replacing the global operator new.
+ */
+
+#include "ssa_reader.h"
+#include "collect.h"
+#include "flat_document.h"
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <new>
+#include <string>
+
+using std::list;
+using std::string;
+using std::cout;
+using boost::posix_time::microsec_clock;
+using boost::posix_time::ptime;
+using namespace sub;
+
+static size_t allocations = 0;
+
+void*
+operator new (size_t size)
+{
+	++allocations;
+	void* p = malloc (size ? size : 1);
+	if (!p) {
+		throw std::bad_alloc ();
+	}
+	return p;
+}
+
+void
+operator delete (void* p) throw ()
+{
+	free (p);
+}
+
+void*
+operator new[] (size_t size)
+{
+	return operator new (size);
+}
+
+void
+operator delete[] (void* p) throw ()
+{
+	operator delete (p);
+}
+
+#if __cplusplus >= 201402L
+void
+operator delete (void* p, size_t) throw ()
+{
+	free (p);
+}
+
+void
+operator delete[] (void* p, size_t) throw ()
+{
+	free (p);
+}
+#endif
+
+static double
+seconds_since (ptime start)
+{
+	return (microsec_clock::universal_time() - start).total_microseconds() / 1e6;
+}
+
+static string
+make_ssa (int cues)
+{
+	string s =
+		"[Script Info]\n"
+		"PlayResX: 1920\n"
+		"PlayResY: 1080\n"
+		"\n"
+		"[V4+ Styles]\n"
+		"Format: Name, Fontname, Fontsize, PrimaryColour, SecondaryColour, OutlineColour, BackColour, Bold, Italic, Underline, StrikeOut, ScaleX, ScaleY, Spacing, Angle, BorderStyle, Outline, Shadow, Alignment, MarginL, MarginR, MarginV, Encoding\n"
+		"Style: Default,Arial,48,&H00FFFFFF,&H000000FF,&H00000000,&H00000000,0,0,0,0,100,100,0,0,1,2,0,2,10,10,40,1\n"
+		"\n"
+		"[Events]\n"
+		"Format: Layer, Start, End, Style, Name, MarginL, MarginR, MarginV, Effect, Text\n";
+
+	for (int i = 0; i < cues; ++i) {
+		int const t = i * 3;
+		char buffer[256];
+		snprintf (
+			buffer, sizeof (buffer),
+			"Dialogue: 0,%d:%02d:%02d.00,%d:%02d:%02d.50,Default,,0,0,0,,This is {\\i1}subtitle{\\i0} %d, with a comma\\Nand a second line\n",
+			t / 3600, (t / 60) % 60, t % 60, t / 3600, (t / 60) % 60, (t % 60) + 2, i
+			);
+		s += buffer;
+	}
+
+	return s;
+}
+
+int
+main ()
+{
+	int const cues = 20000;
+	string const ssa = make_ssa (cues);
+
+	size_t start_allocations = allocations;
+	SSAReader reader (ssa.data(), ssa.size());
+	size_t const read_allocations = allocations - start_allocations;
+
+	start_allocations = allocations;
+	list<Subtitle>* subs = new list<Subtitle> (collect<list<Subtitle> > (reader.subtitles ()));
+	size_t const list_allocations = allocations - start_allocations;
+
+	start_allocations = allocations;
+	FlatDocument* doc = new FlatDocument (collect_flat (reader.subtitles ()));
+	size_t const flat_allocations = allocations - start_allocations;
+
+	/* Destroy the FlatDocument first so that its time does not include the
+	   heap tidying up after the list's many frees.
+	*/
+	ptime start = microsec_clock::universal_time ();
+	delete doc;
+	double const flat_destroy = seconds_since (start);
+
+	start = microsec_clock::universal_time ();
+	delete subs;
+	double const list_destroy = seconds_since (start);
+
+	cout << "Reading " << cues << " cues: " << read_allocations << " allocations\n";
+	cout << "Collecting into std::list<Subtitle>: " << list_allocations << " allocations; destroying took " << list_destroy << "s\n";
+	cout << "Collecting into FlatDocument: " << flat_allocations << " allocations; destroying took " << flat_destroy << "s\n";
+	return 0;
+}
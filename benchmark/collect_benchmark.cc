@@ -0,0 +1,109 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  benchmark/collect_benchmark.cc
+ *  @brief Time collecting 1M RawSubtitles with collect(), and with a simple
+ *  std::list::sort followed by copying each RawSubtitle.
+ */
+
+#include "collect.h"
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <vector>
+
+using std::list;
+using std::vector;
+using std::cout;
+using boost::posix_time::microsec_clock;
+using boost::posix_time::ptime;
+using namespace sub;
+
+static double
+seconds_since (ptime start)
+{
+	return (microsec_clock::universal_time() - start).total_microseconds() / 1e6;
+}
+
+/** @return N RawSubtitles in a random order, with two to each from time */
+static list<RawSubtitle>
+make_raw (int N, Rational rate)
+{
+	srand (1);
+	list<RawSubtitle> raw;
+	for (int i = 0; i < N; ++i) {
+		RawSubtitle r;
+		char buffer[64];
+		snprintf (buffer, sizeof(buffer), "This is line %d of subtitle %d", i % 2, i / 2);
+		r.text = buffer;
+		r.font = "Arial";
+		r.from = Time::from_frames (rand() % (N / 2), rate);
+		r.to = r.from;
+		r.to.add (Time::from_frames (rate.integer_fraction(), rate));
+		r.vertical_position.line = i % 2;
+		r.vertical_position.reference = BOTTOM_OF_SCREEN;
+		raw.push_back (r);
+	}
+	return raw;
+}
+
+/** Collect by sorting the list and copying each RawSubtitle */
+static list<Subtitle>
+simple_collect (list<RawSubtitle> raw)
+{
+	raw.sort ();
+	list<Subtitle> out;
+	for (list<RawSubtitle>::const_iterator i = raw.begin(); i != raw.end(); ++i) {
+		collect_add (out, *i);
+	}
+	return out;
+}
+
+static void
+run (int N, Rational rate, char const * name)
+{
+	list<RawSubtitle> const raw = make_raw (N, rate);
+
+	list<RawSubtitle> copy = raw;
+	ptime start = microsec_clock::universal_time ();
+	list<Subtitle> simple = simple_collect (copy);
+	double const simple_time = seconds_since (start);
+
+	copy = raw;
+	start = microsec_clock::universal_time ();
+	list<Subtitle> collected = collect<list<Subtitle> > (copy);
+	double const collect_time = seconds_since (start);
+
+	cout << name << ": simple " << simple_time << "s, collect() " << collect_time << "s, speed-up " << (simple_time / collect_time);
+	cout << (simple == collected ? "" : " (RESULTS DIFFER)") << "\n";
+}
+
+int
+main ()
+{
+	int const N = 1000000;
+
+	cout << "Collecting " << N << " subtitles\n";
+	/* 25fps Times are whole numbers of ticks, so they can be radix-sorted; 23fps Times are not */
+	run (N, Rational (25, 1), "25fps");
+	run (N, Rational (23, 1), "23fps");
+	return 0;
+}
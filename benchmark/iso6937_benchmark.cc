@@ -0,0 +1,130 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  benchmark/iso6937_benchmark.cc
+ *  @brief Time utf16_to_iso6937 on mostly-ASCII and on heavily-accented text, and
+ *  compare it with searching the decoding tables for each character as it used to.
+ *  Then time decoding the result with iso6937_to_utf8, and with iso6937_to_utf16
+ *  followed by conversion to UTF-8 as STLBinaryReader used to.
+ */
+
+#include "iso6937.h"
+#include "iso6937_tables.h"
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/locale.hpp>
+#include <iostream>
+#include <string>
+
+using std::string;
+using std::wstring;
+using std::cout;
+using boost::posix_time::microsec_clock;
+using boost::posix_time::ptime;
+using boost::locale::conv::utf_to_utf;
+using namespace sub;
+
+static double
+seconds_since (ptime start)
+{
+	return (microsec_clock::universal_time() - start).total_microseconds() / 1e6;
+}
+
+/** @return s repeated until it is at least n characters long */
+static wstring
+repeat (char const * s, size_t n)
+{
+	wstring const w = utf_to_utf<wchar_t> (s);
+	wstring o;
+	o.reserve (n + w.size());
+	while (o.size() < n) {
+		o += w;
+	}
+	return o;
+}
+
+/** utf16_to_iso6937 as it was, searching the decoding tables, without its fallbacks */
+static string
+search_tables (wstring const & s)
+{
+	string o;
+	for (size_t i = 0; i < s.size(); ++i) {
+		bool found = false;
+		for (int j = 0; !found && j < 256; ++j) {
+			int const k = (j + 128) % 256;
+			if (iso6937::main[k] == s[i]) {
+				o += char (k);
+				found = true;
+			}
+		}
+		for (int j = iso6937::first_diacritical; !found && j <= iso6937::last_diacritical; ++j) {
+			for (int k = 0; !found && k < 256; ++k) {
+				if (iso6937::diacriticals[j - iso6937::first_diacritical][k] == s[i]) {
+					o += char (j);
+					o += char (k);
+					found = true;
+				}
+			}
+		}
+	}
+	return o;
+}
+
+static void
+run (char const * name, wstring const & text)
+{
+	ptime start = microsec_clock::universal_time ();
+	string const iso = utf16_to_iso6937 (text);
+	double const table_time = seconds_since (start);
+
+	start = microsec_clock::universal_time ();
+	search_tables (text);
+	double const search_time = seconds_since (start);
+
+	double const mchars = text.size() / 1e6;
+	cout << name << ": " << text.size() << " characters to " << iso.size() << " bytes\n"
+	     << "\tencode with table: " << table_time << "s (" << (mchars / table_time) << "M characters/s)\n"
+	     << "\tencode with search: " << search_time << "s (" << (mchars / search_time) << "M characters/s)\n"
+	     << "\tspeed-up: " << (search_time / table_time) << "\n";
+
+	start = microsec_clock::universal_time ();
+	string const direct = iso6937_to_utf8 (iso.data(), iso.size());
+	double const direct_time = seconds_since (start);
+
+	start = microsec_clock::universal_time ();
+	string const via_utf16 = utf_to_utf<char> (iso6937_to_utf16 (iso));
+	double const via_utf16_time = seconds_since (start);
+
+	if (direct != via_utf16) {
+		cout << "\tdecoders disagree!\n";
+	}
+
+	double const mb = iso.size() / (1024.0 * 1024);
+	cout << "\tdecode to UTF-8: " << direct_time << "s (" << (mb / direct_time) << "MB/s)\n"
+	     << "\tdecode via UTF-16: " << via_utf16_time << "s (" << (mb / via_utf16_time) << "MB/s)\n"
+	     << "\tspeed-up: " << (via_utf16_time / direct_time) << "\n";
+}
+
+int
+main ()
+{
+	size_t const N = 4000000;
+	run ("Mostly ASCII", repeat ("The quick brown fox jumps over the lazy dog, said Zoë. ", N));
+	run ("Accented", repeat ("Ça m'était égal; Dvořák, Łódź, Ærøskøbing, Śląsk, Kraków. ", N));
+	return 0;
+}
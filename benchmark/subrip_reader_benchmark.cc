@@ -0,0 +1,142 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  benchmark/subrip_reader_benchmark.cc
+ *  @brief Time SubripReader on synthetic files of increasing size to check that
+ *  it scales linearly, reading from memory, from a mapped file and from a FILE*,
+ *  and also from memory using as many threads as there are CPU cores.
+ */
+
+#include "subrip_reader.h"
+#include "mapped_file.h"
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/thread.hpp>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+using std::string;
+using std::cout;
+using std::cerr;
+using boost::posix_time::microsec_clock;
+using boost::posix_time::ptime;
+using namespace sub;
+
+static string
+timestamp (int ms)
+{
+	char buffer[64];
+	snprintf (buffer, sizeof(buffer), "%02d:%02d:%02d,%03d", ms / 3600000, (ms / 60000) % 60, (ms / 1000) % 60, ms % 1000);
+	return buffer;
+}
+
+/** @return SRT of at least size bytes */
+static string
+make_srt (size_t size)
+{
+	string s;
+	s.reserve (size + 256);
+	int n = 1;
+	while (s.size() < size) {
+		char buffer[32];
+		snprintf (buffer, sizeof(buffer), "%d\n", n);
+		s += buffer;
+		int const from = n * 2000;
+		s += timestamp (from) + " --> " + timestamp (from + 1500) + "\n";
+		s += "This is the first line of <i>subtitle</i> number " + string (buffer, strlen(buffer) - 1) + "\n";
+		s += "and here is the <b>second</b> line.\n\n";
+		++n;
+	}
+	return s;
+}
+
+static double
+seconds_since (ptime start)
+{
+	return (microsec_clock::universal_time() - start).total_microseconds() / 1e6;
+}
+
+int
+main ()
+{
+	boost::filesystem::path const file = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path ();
+
+	cout << "size/MB\tbuffer/s\tMB/s\tmapped/s\tMB/s\tFILE*/s\tMB/s\t" << boost::thread::hardware_concurrency() << " threads/s\tMB/s\tone thread/s\tMB/s\n";
+
+	for (size_t mb = 12; mb <= 100; mb *= 2) {
+		string const srt = make_srt (mb * 1024 * 1024);
+		double const real_mb = srt.size() / (1024.0 * 1024);
+
+		FILE* f = fopen (file.string().c_str(), "wb");
+		if (!f) {
+			cerr << "Could not open " << file.string() << "\n";
+			return 1;
+		}
+		fwrite (srt.data(), 1, srt.size(), f);
+		fclose (f);
+
+		ptime start = microsec_clock::universal_time ();
+		{
+			SubripReader reader (srt.data(), srt.size(), READ_ON_DEMAND);
+			while (reader.next ()) {}
+		}
+		double const buffer_time = seconds_since (start);
+
+		start = microsec_clock::universal_time ();
+		{
+			MappedFile mapped (file);
+			SubripReader reader (mapped.data(), mapped.size(), READ_ON_DEMAND);
+			while (reader.next ()) {}
+		}
+		double const mapped_time = seconds_since (start);
+
+		start = microsec_clock::universal_time ();
+		{
+			f = fopen (file.string().c_str(), "r");
+			SubripReader reader (f, READ_ON_DEMAND);
+			while (reader.next ()) {}
+			fclose (f);
+		}
+		double const file_time = seconds_since (start);
+
+		start = microsec_clock::universal_time ();
+		{
+			SubripReader reader (srt.data(), srt.size(), READ_ALL, 0);
+		}
+		double const parallel_time = seconds_since (start);
+
+		start = microsec_clock::universal_time ();
+		{
+			SubripReader reader (srt.data(), srt.size(), READ_ALL, 1);
+		}
+		double const serial_time = seconds_since (start);
+
+		cout << real_mb << "\t"
+		     << buffer_time << "\t" << (real_mb / buffer_time) << "\t"
+		     << mapped_time << "\t" << (real_mb / mapped_time) << "\t"
+		     << file_time << "\t" << (real_mb / file_time) << "\t"
+		     << parallel_time << "\t" << (real_mb / parallel_time) << "\t"
+		     << serial_time << "\t" << (real_mb / serial_time) << "\n";
+	}
+
+	boost::filesystem::remove (file);
+	return 0;
+}
@@ -0,0 +1,81 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  benchmark/time_benchmark.cc
+ *  @brief Time sorting 1M subtitles when their Times can be compared using ticks,
+ *  and when they must be compared using seconds, frames and rate.
+ */
+
+#include "raw_subtitle.h"
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using std::vector;
+using std::cout;
+using boost::posix_time::microsec_clock;
+using boost::posix_time::ptime;
+using namespace sub;
+
+static double
+seconds_since (ptime start)
+{
+	return (microsec_clock::universal_time() - start).total_microseconds() / 1e6;
+}
+
+/** @return Time to sort N subtitles whose times are at rate */
+static double
+sort_time (int N, Rational rate)
+{
+	srand (1);
+	vector<RawSubtitle> subs (N);
+	for (int i = 0; i < N; ++i) {
+		subs[i].from = Time::from_hmsf (0, 0, rand() % 7200, rand() % rate.integer_fraction(), rate);
+		subs[i].to = subs[i].from;
+	}
+
+	/* Sort pointers to the subtitles, as collect() does */
+	vector<RawSubtitle const *> sorted;
+	for (vector<RawSubtitle>::const_iterator i = subs.begin(); i != subs.end(); ++i) {
+		sorted.push_back (&(*i));
+	}
+
+	ptime start = microsec_clock::universal_time ();
+	std::stable_sort (sorted.begin(), sorted.end(), raw_subtitle_pointer_less);
+	return seconds_since (start);
+}
+
+int
+main ()
+{
+	int const N = 1000000;
+
+	/* 1000/1 is a whole number of ticks per frame; 1001/1 is not, so comparisons
+	   of those Times are done as they were before Time had ticks.
+	*/
+	double const ticks = sort_time (N, Rational (1000, 1));
+	double const rational = sort_time (N, Rational (1001, 1));
+
+	cout << "Sorting " << N << " subtitles using ticks: " << ticks << "s\n";
+	cout << "Sorting " << N << " subtitles using seconds, frames and rate: " << rational << "s\n";
+	cout << "Speed-up: " << (rational / ticks) << "\n";
+	return 0;
+}
@@ -0,0 +1,112 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  benchmark/timeline_benchmark.cc
+ *  @brief Time finding the subtitles on screen at random times with a linear scan
+ *  and with a Timeline, and at every frame with Timeline::at() and with a Timeline::Cursor.
+ */
+
+#include "timeline.h"
+#include "raw_subtitle.h"
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using std::vector;
+using std::cout;
+using boost::posix_time::microsec_clock;
+using boost::posix_time::ptime;
+using namespace sub;
+
+static double
+seconds_since (ptime start)
+{
+	return (microsec_clock::universal_time() - start).total_microseconds() / 1e6;
+}
+
+int
+main ()
+{
+	int const N = 100000;
+	int const queries = 10000;
+	Rational const rate (25, 1);
+
+	/* A subtitle every 2 seconds or so, on screen for between 1 and 5 seconds */
+	srand (1);
+	vector<RawSubtitle> subs (N);
+	for (int i = 0; i < N; ++i) {
+		int const from = i * 50 + rand() % 25;
+		subs[i].from = Time::from_frames (from, rate);
+		subs[i].to = Time::from_frames (from + 25 + rand() % 100, rate);
+	}
+	int const length = N * 50;
+
+	vector<Time> times;
+	for (int i = 0; i < queries; ++i) {
+		times.push_back (Time::from_frames (rand() % length, rate));
+	}
+
+	ptime start = microsec_clock::universal_time ();
+	Timeline timeline (subs);
+	double const build_time = seconds_since (start);
+
+	size_t linear_found = 0;
+	start = microsec_clock::universal_time ();
+	for (vector<Time>::const_iterator i = times.begin(); i != times.end(); ++i) {
+		for (vector<RawSubtitle>::const_iterator j = subs.begin(); j != subs.end(); ++j) {
+			if (!(*i < j->from) && *i < j->to) {
+				++linear_found;
+			}
+		}
+	}
+	double const linear_time = seconds_since (start);
+
+	size_t timeline_found = 0;
+	vector<size_t> found;
+	start = microsec_clock::universal_time ();
+	for (vector<Time>::const_iterator i = times.begin(); i != times.end(); ++i) {
+		timeline.at (*i, found);
+		timeline_found += found.size ();
+	}
+	double const timeline_time = seconds_since (start);
+
+	size_t at_found = 0;
+	start = microsec_clock::universal_time ();
+	for (int f = 0; f < length; ++f) {
+		timeline.at (Time::from_frames (f, rate), found);
+		at_found += found.size ();
+	}
+	double const at_time = seconds_since (start);
+
+	size_t cursor_found = 0;
+	Timeline::Cursor cursor (timeline);
+	start = microsec_clock::universal_time ();
+	for (int f = 0; f < length; ++f) {
+		cursor_found += cursor.at (Time::from_frames (f, rate)).size ();
+	}
+	double const cursor_time = seconds_since (start);
+
+	cout << "Building a Timeline of " << N << " subtitles: " << build_time << "s\n";
+	cout << queries << " random queries with a linear scan: " << linear_time << "s\n";
+	cout << queries << " random queries with Timeline::at: " << timeline_time << "s" << (linear_found == timeline_found ? "" : " (RESULTS DIFFER)") << "\n";
+	cout << "Every frame (" << length << ") with Timeline::at: " << at_time << "s\n";
+	cout << "Every frame with Timeline::Cursor: " << cursor_time << "s" << (at_found == cursor_found ? "" : " (RESULTS DIFFER)") << "\n";
+	return 0;
+}
@@ -0,0 +1,98 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  src/arena.cc
+ *  @brief Arena and ArenaAllocator classes.
+ */
+
+#include "arena.h"
+#include "sub_assert.h"
+#include <algorithm>
+#include <cstring>
+
+using std::vector;
+using namespace sub;
+
+/** @param chunk_size Size of the chunks that we allocate; anything larger than this
+ *  is given a chunk of its own.
+ */
+Arena::Arena (size_t chunk_size)
+	: _chunk_size (chunk_size)
+	, _chunk (0)
+	, _chunk_capacity (0)
+	, _used (0)
+	, _bytes (0)
+	, _heap_allocations (0)
+{
+	SUB_ASSERT (chunk_size > 0);
+}
+
+Arena::~Arena ()
+{
+	clear ();
+}
+
+void*
+Arena::allocate_slow (size_t n, size_t align)
+{
+	SUB_ASSERT (align > 0 && (align & (align - 1)) == 0);
+
+	size_t const capacity = std::max (_chunk_size, n + align);
+	char* chunk = new char[capacity];
+	++_heap_allocations;
+	_chunks.push_back (chunk);
+
+	size_t const offset = padding (chunk, align);
+	_bytes += n;
+
+	if (n < _chunk_size || !_chunk) {
+		/* Allocate from this chunk from now on */
+		_chunk = chunk;
+		_chunk_capacity = capacity;
+		_used = offset + n;
+	}
+	/* otherwise this is a big allocation with a chunk of its own, and we keep using
+	   the chunk that we had for small ones.
+	*/
+
+	return chunk + offset;
+}
+
+/** @return A copy of some data in this arena */
+char const *
+Arena::copy (char const * data, size_t size)
+{
+	char* p = static_cast<char *> (allocate (size, 1));
+	memcpy (p, data, size);
+	return p;
+}
+
+/** Free everything that has been allocated from this arena */
+void
+Arena::clear ()
+{
+	for (vector<char *>::const_iterator i = _chunks.begin(); i != _chunks.end(); ++i) {
+		delete[] *i;
+	}
+	_chunks.clear ();
+	_chunk = 0;
+	_chunk_capacity = 0;
+	_used = 0;
+	_bytes = 0;
+}
@@ -0,0 +1,180 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  src/arena.h
+ *  @brief Arena and ArenaAllocator classes.
+ */
+
+#ifndef LIBSUB_ARENA_H
+#define LIBSUB_ARENA_H
+
+#include <boost/noncopyable.hpp>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace sub {
+
+/** @class Arena
+ *  @brief A simple monotonic allocator: memory is taken from large chunks and is
+ *  only given back, all at once, when the Arena is cleared or destroyed.
+ *
+ *  This is for things which are made together and thrown away together, such as the
+ *  text of a document; making them costs an allocation per chunk rather than one
+ *  per object, and destroying them costs a free per chunk.
+ */
+class Arena : public boost::noncopyable
+{
+public:
+	explicit Arena (size_t chunk_size = 65536);
+	~Arena ();
+
+	/** @return n bytes, aligned to align (which must be a power of 2) */
+	void* allocate (size_t n, size_t align = sizeof (void *)) {
+		size_t const offset = _used + padding (_chunk + _used, align);
+		if (_chunk && offset + n <= _chunk_capacity) {
+			_used = offset + n;
+			_bytes += n;
+			return _chunk + offset;
+		}
+		return allocate_slow (n, align);
+	}
+
+	char const * copy (char const * data, size_t size);
+
+	void clear ();
+
+	/** @return number of times that we have had to allocate memory from the heap */
+	size_t heap_allocations () const {
+		return _heap_allocations;
+	}
+
+	/** @return number of bytes that have been allocated from us */
+	size_t bytes () const {
+		return _bytes;
+	}
+
+private:
+	void* allocate_slow (size_t n, size_t align);
+
+	/** @return number of bytes to add to p to align it to align */
+	static size_t padding (char const * p, size_t align) {
+		return (align - (reinterpret_cast<size_t> (p) & (align - 1))) & (align - 1);
+	}
+
+	size_t _chunk_size;
+	/** chunks that we have allocated */
+	std::vector<char *> _chunks;
+	/** chunk that we are allocating from, or 0 */
+	char* _chunk;
+	/** capacity of _chunk in bytes */
+	size_t _chunk_capacity;
+	/** bytes of _chunk that have been used */
+	size_t _used;
+	size_t _bytes;
+	size_t _heap_allocations;
+};
+
+/** @class ArenaAllocator
+ *  @brief A standard allocator which takes its memory from an Arena, so that standard
+ *  containers can use one.  Memory is not given back until the Arena is cleared.
+ */
+template <class T>
+class ArenaAllocator
+{
+public:
+	typedef T value_type;
+	typedef T* pointer;
+	typedef T const * const_pointer;
+	typedef T& reference;
+	typedef T const & const_reference;
+	typedef size_t size_type;
+	typedef std::ptrdiff_t difference_type;
+
+	template <class U>
+	struct rebind {
+		typedef ArenaAllocator<U> other;
+	};
+
+	explicit ArenaAllocator (Arena* arena)
+		: _arena (arena)
+	{}
+
+	template <class U>
+	ArenaAllocator (ArenaAllocator<U> const & other)
+		: _arena (other.arena ())
+	{}
+
+	pointer allocate (size_type n, void const * = 0) {
+		return static_cast<pointer> (_arena->allocate (n * sizeof (T), alignment ()));
+	}
+
+	void deallocate (pointer, size_type) {}
+
+	void construct (pointer p, T const & v) {
+		new (p) T (v);
+	}
+
+	void destroy (pointer p) {
+		p->~T ();
+	}
+
+	pointer address (reference r) const {
+		return &r;
+	}
+
+	const_pointer address (const_reference r) const {
+		return &r;
+	}
+
+	size_type max_size () const {
+		return size_t (-1) / sizeof (T);
+	}
+
+	Arena* arena () const {
+		return _arena;
+	}
+
+private:
+	static size_t alignment () {
+		/* The size of a struct of a char and a T is T's alignment plus its size */
+		struct Align { char c; T t; };
+		return sizeof (Align) - sizeof (T);
+	}
+
+	Arena* _arena;
+};
+
+template <class T, class U>
+bool
+operator== (ArenaAllocator<T> const & a, ArenaAllocator<U> const & b)
+{
+	return a.arena() == b.arena();
+}
+
+template <class T, class U>
+bool
+operator!= (ArenaAllocator<T> const & a, ArenaAllocator<U> const & b)
+{
+	return a.arena() != b.arena();
+}
+
+}
+
+#endif
@@ -22,42 +22,103 @@
 
 #include "subtitle.h"
 #include "raw_subtitle.h"
+#include <iterator>
+#include <vector>
 
 namespace sub {
 
+/** Add a RawSubtitle to the end of a container of Subtitles, either as a new Subtitle
+ *  or as part of the last one.  RawSubtitles must be added in time order.
+ *  @return The Block that was created for the RawSubtitle.
+ */
+template <class T>
+Block &
+collect_add (T& out, RawSubtitle const & raw)
+{
+	if (!out.empty() && out.back().same_metadata (raw)) {
+		/* This RawSubtitle can be added to the last Subtitle... */
+		Subtitle& current = out.back ();
+		if (!current.lines.empty() && current.lines.back().same_metadata (raw)) {
+			/* ... and indeed to its last line */
+			current.lines.back().blocks.push_back (Block (raw));
+		} else {
+			/* ... as a new line */
+			current.lines.push_back (Line (raw));
+		}
+		return current.lines.back().blocks.back ();
+	}
+
+	/* We must start a new Subtitle */
+	out.push_back (Subtitle (raw));
+	return out.back().lines.back().blocks.back ();
+}
+
+/** Add a RawSubtitle to a container of Subtitles as collect_add() does, but move its
+ *  text and font into the result rather than copying them.
+ */
+template <class T>
+Block &
+collect_take (T& out, RawSubtitle& raw)
+{
+	std::string text;
+	text.swap (raw.text);
+	boost::optional<std::string> font;
+	font.swap (raw.font);
+
+	Block& block = collect_add (out, raw);
+	block.text.swap (text);
+	block.font.swap (font);
+	return block;
+}
+
 /** Collect sub::RawSubtitle objects into sub::Subtitles.
  *  This method is templated so that any container type can be used for the result.
+ *
+ *  raw is taken by value and its text and fonts are moved (rather than copied) into the result,
+ *  so passing a temporary (such as the result of Reader::take_subtitles()) means that
+ *  the subtitles are never copied.  raw is sorted by sorting pointers into it, so its
+ *  nodes are never relinked.
  */
 template <class T>
 T
 collect (std::list<RawSubtitle> raw)
 {
-	raw.sort ();
+	std::vector<RawSubtitle *> sorted;
+	sorted.reserve (raw.size ());
+	for (std::list<RawSubtitle>::iterator i = raw.begin (); i != raw.end(); ++i) {
+		sorted.push_back (&(*i));
+	}
+
+	sort_raw_subtitles (sorted);
 
 	T out;
 
-	boost::optional<Subtitle> current;
-	for (std::list<RawSubtitle>::const_iterator i = raw.begin (); i != raw.end(); ++i) {
-		if (current && current->same_metadata (*i)) {
-			/* This RawSubtitle can be added to current... */
-			if (!current->lines.empty() && current->lines.back().same_metadata (*i)) {
-				/* ... and indeed to its last line */
-				current->lines.back().blocks.push_back (Block (*i));
-			} else {
-				/* ... as a new line */
-				current->lines.push_back (Line (*i));
-			}
-		} else {
-			/* We must start a new Subtitle */
-			if (current) {
-				out.push_back (current.get ());
-			}
-			current = Subtitle (*i);
-		}
+	for (std::vector<RawSubtitle *>::const_iterator i = sorted.begin(); i != sorted.end(); ++i) {
+		collect_take (out, **i);
 	}
 
-	if (current) {
-		out.push_back (current.get ());
+	return out;
+}
+
+/** Collect a range of sub::RawSubtitle objects into sub::Subtitles without copying the range.
+ *  This method is templated so that any container type can be used for the result.
+ */
+template <class T, class Iterator>
+T
+collect (Iterator begin, Iterator end)
+{
+	std::vector<RawSubtitle const *> sorted;
+	sorted.reserve (std::distance (begin, end));
+	for (Iterator i = begin; i != end; ++i) {
+		sorted.push_back (&(*i));
+	}
+
+	sort_raw_subtitles (sorted);
+
+	T out;
+
+	for (std::vector<RawSubtitle const *>::const_iterator i = sorted.begin(); i != sorted.end(); ++i) {
+		collect_add (out, **i);
 	}
 
 	return out;
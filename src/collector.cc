@@ -0,0 +1,106 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  src/collector.cc
+ *  @brief Collector class.
+ */
+
+#include "collector.h"
+#include "collect.h"
+#include "sub_assert.h"
+
+using std::list;
+using namespace sub;
+
+/** @param window Longest time by which a RawSubtitle's from time may precede the
+ *  latest from time of those added before it.  Its rate must be specified.
+ */
+Collector::Collector (Time window)
+	: _window (window)
+	, _finished (false)
+{
+
+}
+
+/** Add a RawSubtitle, after which some Subtitles may be ready to get() */
+void
+Collector::add (RawSubtitle const & raw)
+{
+	SUB_ASSERT (!_finished);
+
+	/* Insert after anything with an earlier or equal from time; usually this is the end */
+	list<RawSubtitle>::reverse_iterator i = _pending.rbegin ();
+	while (i != _pending.rend() && raw.from < i->from) {
+		++i;
+	}
+	_pending.insert (i.base(), raw);
+
+	Time horizon = raw.from;
+	horizon.subtract (_window);
+	if (!_horizon || *_horizon < horizon) {
+		_horizon = horizon;
+	}
+
+	collect_ready ();
+}
+
+/** Say that there will be no more input, so that everything that has been
+ *  added will be ready to get().
+ */
+void
+Collector::finish ()
+{
+	_finished = true;
+	collect_ready ();
+}
+
+/** @param subtitle Filled in with the next Subtitle, if there is one.
+ *  @return true if there was a Subtitle, false if we need more input (or there
+ *  will be no more output, if finish() has been called).
+ */
+bool
+Collector::get (Subtitle& subtitle)
+{
+	if (_ready.empty ()) {
+		return false;
+	}
+
+	Subtitle& s = _ready.front ();
+	subtitle.from = s.from;
+	subtitle.to = s.to;
+	subtitle.fade_up = s.fade_up;
+	subtitle.fade_down = s.fade_down;
+	subtitle.lines.clear ();
+	subtitle.lines.swap (s.lines);
+	_ready.pop_front ();
+	return true;
+}
+
+/** Collect RawSubtitles that nothing else can be added to.  Everything with a given
+ *  from time is collected at once, since they are the only RawSubtitles that can be
+ *  put into the same Subtitle.
+ */
+void
+Collector::collect_ready ()
+{
+	while (!_pending.empty() && (_finished || _pending.front().from < *_horizon)) {
+		collect_take (_ready, _pending.front ());
+		_pending.pop_front ();
+	}
+}
@@ -0,0 +1,78 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  src/collector.h
+ *  @brief Collector class.
+ */
+
+#ifndef LIBSUB_COLLECTOR_H
+#define LIBSUB_COLLECTOR_H
+
+#include "subtitle.h"
+#include "raw_subtitle.h"
+#include <boost/noncopyable.hpp>
+#include <boost/optional.hpp>
+#include <list>
+
+namespace sub {
+
+/** @class Collector
+ *  @brief Collects RawSubtitles into Subtitles as they arrive, rather than all at once
+ *  as collect() does.
+ *
+ *  RawSubtitles must be given to add() roughly in order of their from times: none may
+ *  start more than some window before the latest from time so far.  A Subtitle is then
+ *  available from get() as soon as it is certain that no more RawSubtitles can be added
+ *  to it, and the result is the same as collect() would give for the whole input.
+ *
+ *  RawSubtitles which arrive later than the window allows are still collected,
+ *  but on their own, and as soon as possible.
+ */
+class Collector : public boost::noncopyable
+{
+public:
+	explicit Collector (Time window);
+
+	void add (RawSubtitle const & raw);
+	void finish ();
+	bool get (Subtitle& subtitle);
+
+	/** @return number of RawSubtitles which have been added but not yet collected */
+	size_t pending () const {
+		return _pending.size ();
+	}
+
+private:
+	void collect_ready ();
+
+	/** the window */
+	Time _window;
+	/** RawSubtitles that start before this time can be collected */
+	boost::optional<Time> _horizon;
+	/** RawSubtitles that have been added but not collected, sorted by from time */
+	std::list<RawSubtitle> _pending;
+	/** Subtitles that are ready to be returned by get() */
+	std::list<Subtitle> _ready;
+	/** true if finish() has been called */
+	bool _finished;
+};
+
+}
+
+#endif
@@ -23,7 +23,6 @@
 #include <dcp/subtitle_string.h>
 #include <dcp/interop_subtitle_asset.h>
 #include <dcp/smpte_subtitle_asset.h>
-#include <boost/foreach.hpp>
 #include <boost/filesystem.hpp>
 
 using std::list;
@@ -47,7 +46,7 @@ dcp_to_sub_colour (dcp::Colour c)
 	return Colour (c.r / 255.0, c.g / 255.0, c.b / 255.0);
 }
 
-DCPReader::DCPReader (boost::filesystem::path file)
+DCPReader::DCPReader (boost::filesystem::path file, ReadMode mode)
 {
 	shared_ptr<dcp::SubtitleAsset> sc;
 	string interop_error;
@@ -71,69 +70,84 @@ DCPReader::DCPReader (boost::filesystem::path file)
 		throw DCPError (String::compose ("Could not read subtitles (%1 / %2)", interop_error, smpte_error));
 	}
 
+	/* libdcp has to parse the whole asset, but we convert its subtitles to ours as they are asked for */
+	_dcp_subs = sc->subtitles ();
 
-	BOOST_FOREACH (shared_ptr<dcp::Subtitle> i, sc->subtitles ()) {
+	if (mode == READ_ALL) {
+		read_all ();
+	}
+}
 
-		/* We don't deal with image subs */
-		shared_ptr<dcp::SubtitleString> is = dynamic_pointer_cast<dcp::SubtitleString>(i);
-		if (!is) {
-			continue;
-		}
+/** Convert one subtitle from the asset */
+bool
+DCPReader::read_more ()
+{
+	if (_dcp_subs.empty ()) {
+		return false;
+	}
 
-		RawSubtitle rs;
-		rs.text = is->text ();
-		rs.font = is->font ();
-		rs.font_size = FontSize::from_proportional (is->size() / (72.0 * 11.0));
-
-		switch (is->effect ()) {
-		case dcp::BORDER:
-			rs.effect = BORDER;
-			break;
-		case dcp::SHADOW:
-			rs.effect = SHADOW;
-			break;
-		default:
-			break;
-		}
+	/* We don't deal with image subs */
+	shared_ptr<dcp::SubtitleString> is = dynamic_pointer_cast<dcp::SubtitleString>(_dcp_subs.front ());
+	_dcp_subs.pop_front ();
+	if (!is) {
+		return true;
+	}
 
-		rs.effect_colour = dcp_to_sub_colour (is->effect_colour());
-
-		rs.colour = dcp_to_sub_colour (is->colour());
-		rs.bold = is->bold ();
-		rs.italic = is->italic ();
-		rs.underline = is->underline ();
-
-		switch (is->h_align()) {
-		case dcp::HALIGN_LEFT:
-			rs.horizontal_position.reference = LEFT_OF_SCREEN;
-			break;
-		case dcp::HALIGN_CENTER:
-			rs.horizontal_position.reference = HORIZONTAL_CENTRE_OF_SCREEN;
-			break;
-		case dcp::HALIGN_RIGHT:
-			rs.horizontal_position.reference = RIGHT_OF_SCREEN;
-			break;
-		}
+	RawSubtitle rs;
+	rs.text = is->text ();
+	rs.font = is->font ();
+	rs.font_size = FontSize::from_proportional (is->size() / (72.0 * 11.0));
+
+	switch (is->effect ()) {
+	case dcp::BORDER:
+		rs.effect = BORDER;
+		break;
+	case dcp::SHADOW:
+		rs.effect = SHADOW;
+		break;
+	default:
+		break;
+	}
 
-		rs.vertical_position.proportional = is->v_position();
-		switch (is->v_align()) {
-		case dcp::VALIGN_TOP:
-			rs.vertical_position.reference = TOP_OF_SCREEN;
-			break;
-		case dcp::VALIGN_CENTER:
-			rs.vertical_position.reference = VERTICAL_CENTRE_OF_SCREEN;
-			break;
-		case dcp::VALIGN_BOTTOM:
-			rs.vertical_position.reference = BOTTOM_OF_SCREEN;
-			break;
-		}
+	rs.effect_colour = dcp_to_sub_colour (is->effect_colour());
+
+	rs.colour = dcp_to_sub_colour (is->colour());
+	rs.bold = is->bold ();
+	rs.italic = is->italic ();
+	rs.underline = is->underline ();
+
+	switch (is->h_align()) {
+	case dcp::HALIGN_LEFT:
+		rs.horizontal_position.reference = LEFT_OF_SCREEN;
+		break;
+	case dcp::HALIGN_CENTER:
+		rs.horizontal_position.reference = HORIZONTAL_CENTRE_OF_SCREEN;
+		break;
+	case dcp::HALIGN_RIGHT:
+		rs.horizontal_position.reference = RIGHT_OF_SCREEN;
+		break;
+	}
 
-		rs.from = dcp_to_sub_time (is->in ());
-		rs.to = dcp_to_sub_time (is->out ());
+	rs.vertical_position.proportional = is->v_position();
+	switch (is->v_align()) {
+	case dcp::VALIGN_TOP:
+		rs.vertical_position.reference = TOP_OF_SCREEN;
+		break;
+	case dcp::VALIGN_CENTER:
+		rs.vertical_position.reference = VERTICAL_CENTRE_OF_SCREEN;
+		break;
+	case dcp::VALIGN_BOTTOM:
+		rs.vertical_position.reference = BOTTOM_OF_SCREEN;
+		break;
+	}
 
-		rs.fade_up = dcp_to_sub_time (is->fade_up_time ());
-		rs.fade_down = dcp_to_sub_time (is->fade_down_time ());
+	rs.from = dcp_to_sub_time (is->in ());
+	rs.to = dcp_to_sub_time (is->out ());
 
-		_subs.push_back (rs);
-	}
+	rs.fade_up = dcp_to_sub_time (is->fade_up_time ());
+	rs.fade_down = dcp_to_sub_time (is->fade_down_time ());
+
+	_subs.push_back (rs);
+
+	return true;
 }
@@ -22,6 +22,11 @@
 
 #include "reader.h"
 #include <boost/filesystem.hpp>
+#include <boost/shared_ptr.hpp>
+
+namespace dcp {
+	class Subtitle;
+}
 
 namespace sub {
 
@@ -31,7 +36,13 @@ namespace sub {
 class DCPReader : public Reader
 {
 public:
-	DCPReader (boost::filesystem::path file);
+	DCPReader (boost::filesystem::path file, ReadMode mode = READ_ALL);
+
+private:
+	bool read_more ();
+
+	/** Subtitles from the asset that we have yet to convert */
+	std::list<boost::shared_ptr<dcp::Subtitle> > _dcp_subs;
 };
 
 }
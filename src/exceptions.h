@@ -37,6 +37,17 @@ public:
 	{}
 };
 
+/** @class FileError
+ *  @brief An error raised when a file cannot be opened or read.
+ */
+class FileError : public std::runtime_error
+{
+public:
+	FileError (std::string const & message)
+		: std::runtime_error (message)
+	{}
+};
+
 /** @class STLError
  *  @brief An error raised when reading a binary STL file.
  */
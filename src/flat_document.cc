@@ -0,0 +1,162 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  src/flat_document.cc
+ *  @brief FlatDocument class and its parts.
+ */
+
+#include "flat_document.h"
+
+using std::list;
+using std::string;
+using std::vector;
+using namespace sub;
+
+/** Add a block to the end of blocks, putting its text into our Arena and its style into the table */
+void
+FlatDocument::push_block (string const & text, Style const & style)
+{
+	FlatBlock b;
+	b.text = _arena->copy (text.data(), text.size());
+	b.text_size = text.size ();
+	/* Consecutive blocks very often have the same style, so check that before looking it up */
+	if (!blocks.empty() && styles.get(blocks.back().style) == style) {
+		b.style = blocks.back().style;
+	} else {
+		b.style = styles.add (style);
+	}
+	blocks.push_back (b);
+}
+
+/** Add a Subtitle to the end of this document */
+void
+FlatDocument::add (Subtitle const & subtitle)
+{
+	FlatSubtitle s;
+	s.from = subtitle.from;
+	s.to = subtitle.to;
+	s.fade_up = subtitle.fade_up;
+	s.fade_down = subtitle.fade_down;
+	s.first_line = lines.size ();
+	s.line_count = subtitle.lines.size ();
+
+	for (list<Line>::const_iterator i = subtitle.lines.begin(); i != subtitle.lines.end(); ++i) {
+		FlatLine l;
+		l.horizontal_position = i->horizontal_position;
+		l.vertical_position = i->vertical_position;
+		l.first_block = blocks.size ();
+		l.block_count = i->blocks.size ();
+		for (list<Block>::const_iterator j = i->blocks.begin(); j != i->blocks.end(); ++j) {
+			push_block (j->text, Style (*j));
+		}
+		lines.push_back (l);
+	}
+
+	subtitles.push_back (s);
+}
+
+/** Add a RawSubtitle to the end of this document, either as a new subtitle or as part
+ *  of the last one, as collect_add() does.  RawSubtitles must be added in time order.
+ */
+void
+FlatDocument::add (RawSubtitle const & raw)
+{
+	if (subtitles.empty() || !(subtitles.back().from == raw.from && subtitles.back().to == raw.to && subtitles.back().fade_up == raw.fade_up && subtitles.back().fade_down == raw.fade_down)) {
+		/* We must start a new subtitle */
+		FlatSubtitle s;
+		s.from = raw.from;
+		s.to = raw.to;
+		s.fade_up = raw.fade_up;
+		s.fade_down = raw.fade_down;
+		s.first_line = lines.size ();
+		subtitles.push_back (s);
+	}
+
+	FlatSubtitle& current = subtitles.back ();
+	if (current.line_count == 0 || !(lines.back().vertical_position == raw.vertical_position)) {
+		/* We must start a new line */
+		FlatLine l;
+		l.horizontal_position = raw.horizontal_position;
+		l.vertical_position = raw.vertical_position;
+		l.first_block = blocks.size ();
+		lines.push_back (l);
+		++current.line_count;
+	}
+
+	push_block (raw.text, Style (raw));
+	++lines.back().block_count;
+}
+
+/** @return A Subtitle made from one of our subtitles */
+Subtitle
+FlatDocument::subtitle (FlatSubtitle const & s) const
+{
+	Subtitle out;
+	out.from = s.from;
+	out.to = s.to;
+	out.fade_up = s.fade_up;
+	out.fade_down = s.fade_down;
+
+	for (size_t i = s.first_line; i < s.first_line + s.line_count; ++i) {
+		FlatLine const & fl = lines[i];
+		out.lines.push_back (Line ());
+		Line& l = out.lines.back ();
+		l.horizontal_position = fl.horizontal_position;
+		l.vertical_position = fl.vertical_position;
+		for (size_t j = fl.first_block; j < fl.first_block + fl.block_count; ++j) {
+			FlatBlock const & fb = blocks[j];
+			l.blocks.push_back (Block ());
+			Block& b = l.blocks.back ();
+			b.text = text_string (fb);
+			style(fb).apply (b);
+		}
+	}
+
+	return out;
+}
+
+void
+FlatDocument::clear ()
+{
+	subtitles.clear ();
+	lines.clear ();
+	blocks.clear ();
+	styles.clear ();
+	_arena.reset (new Arena);
+}
+
+/** Collect sub::RawSubtitle objects into a FlatDocument, giving the same subtitles as collect() */
+FlatDocument
+sub::collect_flat (list<RawSubtitle> const & raw)
+{
+	vector<RawSubtitle const *> sorted;
+	sorted.reserve (raw.size ());
+	for (list<RawSubtitle>::const_iterator i = raw.begin(); i != raw.end(); ++i) {
+		sorted.push_back (&(*i));
+	}
+
+	sort_raw_subtitles (sorted);
+
+	FlatDocument doc;
+	for (vector<RawSubtitle const *>::const_iterator i = sorted.begin(); i != sorted.end(); ++i) {
+		doc.add (**i);
+	}
+
+	return doc;
+}
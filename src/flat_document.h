@@ -0,0 +1,177 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  src/flat_document.h
+ *  @brief FlatDocument class and its parts.
+ */
+
+#ifndef LIBSUB_FLAT_DOCUMENT_H
+#define LIBSUB_FLAT_DOCUMENT_H
+
+#include "subtitle.h"
+#include "raw_subtitle.h"
+#include "style.h"
+#include "arena.h"
+#include <boost/optional.hpp>
+#include <boost/shared_ptr.hpp>
+#include <list>
+#include <string>
+#include <vector>
+
+namespace sub {
+
+/** @class FlatBlock
+ *  @brief A Block in a FlatDocument, whose text is in the document's Arena
+ *  and whose style is in the document's StyleTable.
+ */
+class FlatBlock
+{
+public:
+	FlatBlock ()
+		: text (0)
+		, text_size (0)
+		, style (0)
+	{}
+
+	/** text in UTF-8, which is not zero-terminated */
+	char const * text;
+	/** length of the text in bytes */
+	size_t text_size;
+	StyleId style;
+};
+
+/** @class FlatLine
+ *  @brief A Line in a FlatDocument, whose blocks are a range of the document's blocks.
+ */
+class FlatLine
+{
+public:
+	FlatLine ()
+		: first_block (0)
+		, block_count (0)
+	{}
+
+	HorizontalPosition horizontal_position;
+
+	/** vertical position of the baseline of the text */
+	VerticalPosition vertical_position;
+
+	size_t first_block;
+	size_t block_count;
+};
+
+/** @class FlatSubtitle
+ *  @brief A Subtitle in a FlatDocument, whose lines are a range of the document's lines.
+ */
+class FlatSubtitle
+{
+public:
+	FlatSubtitle ()
+		: first_line (0)
+		, line_count (0)
+	{}
+
+	/** from time */
+	Time from;
+	/** to time */
+	Time to;
+
+	boost::optional<Time> fade_up;
+	boost::optional<Time> fade_down;
+
+	size_t first_line;
+	size_t line_count;
+};
+
+/** @class FlatDocument
+ *  @brief Some collected subtitles, held in a few arrays rather than the lists of
+ *  lists of Subtitle, Line and Block.
+ *
+ *  Each subtitle's lines, and each line's blocks, are consecutive entries in the
+ *  lines and blocks arrays, and all text is kept in an Arena, so walking over a
+ *  document is a walk along each of these in turn, and destroying one is a
+ *  handful of frees.
+ */
+class FlatDocument
+{
+public:
+	FlatDocument ()
+		: _arena (new Arena)
+	{}
+
+	/** @param subtitles Container of Subtitles */
+	template <class T>
+	explicit FlatDocument (T const & subtitles)
+		: _arena (new Arena)
+	{
+		for (typename T::const_iterator i = subtitles.begin(); i != subtitles.end(); ++i) {
+			add (*i);
+		}
+	}
+
+	void add (Subtitle const & subtitle);
+	void add (RawSubtitle const & raw);
+
+	/** @return A container of Subtitles made from this document */
+	template <class T>
+	T as () const
+	{
+		T out;
+		for (std::vector<FlatSubtitle>::const_iterator i = subtitles.begin(); i != subtitles.end(); ++i) {
+			out.push_back (subtitle (*i));
+		}
+		return out;
+	}
+
+	Subtitle subtitle (FlatSubtitle const & s) const;
+
+	std::string text_string (FlatBlock const & b) const {
+		return std::string (b.text, b.text_size);
+	}
+
+	/** @return the Arena that holds our text */
+	Arena const & arena () const {
+		return *_arena;
+	}
+
+	Style const & style (FlatBlock const & b) const {
+		return styles.get (b.style);
+	}
+
+	void clear ();
+
+	std::vector<FlatSubtitle> subtitles;
+	std::vector<FlatLine> lines;
+	std::vector<FlatBlock> blocks;
+	StyleTable styles;
+
+private:
+	void push_block (std::string const & text, Style const & style);
+
+	/** text of all blocks; this is shared by copies of this document, whose
+	 *  blocks point into it.
+	 */
+	boost::shared_ptr<Arena> _arena;
+};
+
+extern FlatDocument collect_flat (std::list<RawSubtitle> const & raw);
+
+}
+
+#endif
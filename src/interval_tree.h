@@ -0,0 +1,271 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  src/interval_tree.h
+ *  @brief IntervalTree and IntervalTreeCursor classes.
+ */
+
+#ifndef LIBSUB_INTERVAL_TREE_H
+#define LIBSUB_INTERVAL_TREE_H
+
+#include <boost/optional.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace sub {
+
+/** @class IntervalTree
+ *  @brief A set of intervals [from, to), kept sorted by from as a balanced binary
+ *  tree laid out in that order where each node knows the latest to of the intervals
+ *  below it.
+ *
+ *  T can be anything with a strict weak ordering given by operator<.  Intervals are
+ *  referred to by their position in the sorted order; index() gives the index that
+ *  an interval had in the vectors that it was built from.  Equal froms are sorted
+ *  in the order of those vectors.
+ */
+template <class T>
+class IntervalTree
+{
+public:
+	void build (std::vector<T> const & from, std::vector<T> const & to)
+	{
+		size_t const n = from.size ();
+
+		_order.resize (n);
+		for (size_t i = 0; i < n; ++i) {
+			_order[i] = i;
+		}
+
+		std::stable_sort (_order.begin(), _order.end(), IndexLess (from));
+
+		_from.resize (n);
+		_to.resize (n);
+		for (size_t i = 0; i < n; ++i) {
+			_from[i] = from[_order[i]];
+			_to[i] = to[_order[i]];
+		}
+
+		_max_to.resize (n);
+		build_max_to (0, n);
+	}
+
+	/** @return number of intervals */
+	size_t size () const {
+		return _order.size ();
+	}
+
+	/** @return index in the vectors that the tree was built from of the interval at position */
+	size_t index (size_t position) const {
+		return _order[position];
+	}
+
+	T const & from (size_t position) const {
+		return _from[position];
+	}
+
+	T const & to (size_t position) const {
+		return _to[position];
+	}
+
+	/** Add the positions of intervals which contain t, in ascending order */
+	void at (T const & t, std::vector<size_t>& positions) const {
+		at (t, 0, _order.size(), positions);
+	}
+
+	/** Add the positions of intervals which overlap [from, to), in ascending order */
+	void during (T const & from, T const & to, std::vector<size_t>& positions) const {
+		during (from, to, 0, _order.size(), positions);
+	}
+
+	/** @return position of the first interval which starts after t */
+	size_t first_after (T const & t) const {
+		return std::upper_bound (_from.begin(), _from.end(), t) - _from.begin();
+	}
+
+private:
+	/** Comparator to sort indices by the froms that they refer to */
+	class IndexLess
+	{
+	public:
+		explicit IndexLess (std::vector<T> const & from)
+			: _from (from)
+		{}
+
+		bool operator() (size_t a, size_t b) const {
+			return _from[a] < _from[b];
+		}
+
+	private:
+		std::vector<T> const & _from;
+	};
+
+	/** Fill in _max_to for the subtree covering [begin, end) */
+	void build_max_to (size_t begin, size_t end)
+	{
+		if (begin >= end) {
+			return;
+		}
+
+		size_t const mid = (begin + end) / 2;
+		build_max_to (begin, mid);
+		build_max_to (mid + 1, end);
+
+		T m = _to[mid];
+		if (begin < mid && m < _max_to[(begin + mid) / 2]) {
+			m = _max_to[(begin + mid) / 2];
+		}
+		if (mid + 1 < end && m < _max_to[(mid + 1 + end) / 2]) {
+			m = _max_to[(mid + 1 + end) / 2];
+		}
+		_max_to[mid] = m;
+	}
+
+	void at (T const & t, size_t begin, size_t end, std::vector<size_t>& positions) const
+	{
+		while (begin < end) {
+			size_t const mid = (begin + end) / 2;
+			if (!(t < _max_to[mid])) {
+				/* Everything here has ended by t */
+				return;
+			}
+
+			at (t, begin, mid, positions);
+
+			if (t < _from[mid]) {
+				/* This and everything after it have not started by t */
+				return;
+			}
+
+			if (t < _to[mid]) {
+				positions.push_back (mid);
+			}
+
+			begin = mid + 1;
+		}
+	}
+
+	void during (T const & from, T const & to, size_t begin, size_t end, std::vector<size_t>& positions) const
+	{
+		while (begin < end) {
+			size_t const mid = (begin + end) / 2;
+			if (!(from < _max_to[mid])) {
+				return;
+			}
+
+			during (from, to, begin, mid, positions);
+
+			if (!(_from[mid] < to)) {
+				return;
+			}
+
+			if (from < _to[mid]) {
+				positions.push_back (mid);
+			}
+
+			begin = mid + 1;
+		}
+	}
+
+	/** indices of intervals sorted by from */
+	std::vector<size_t> _order;
+	/** froms in sorted order */
+	std::vector<T> _from;
+	/** tos in sorted order */
+	std::vector<T> _to;
+	/** latest to of the subtree whose root is each position in sorted order;
+	 *  the subtree for [begin, end) has its root at (begin + end) / 2.
+	 */
+	std::vector<T> _max_to;
+};
+
+/** @class IntervalTreeCursor
+ *  @brief Something to step through an IntervalTree in order, finding which intervals
+ *  contain each value more cheaply than by calling IntervalTree::at() each time.
+ *
+ *  Moving forward costs O(1) amortised plus the number of intervals containing the
+ *  value; moving backwards, or a long way forwards, uses IntervalTree::at().
+ */
+template <class T>
+class IntervalTreeCursor
+{
+public:
+	/** @param tree Tree, which must outlive this object */
+	explicit IntervalTreeCursor (IntervalTree<T> const & tree)
+		: _tree (tree)
+		, _next (0)
+	{}
+
+	/** Move to a value.
+	 *  @return positions of the intervals which contain t, in ascending order; valid
+	 *  until the next call to move().
+	 */
+	std::vector<size_t> const & move (T const & t)
+	{
+		if ((_last && t < *_last) || (_next + seek_threshold < _tree.size() && !(t < _tree.from (_next + seek_threshold)))) {
+			/* Going backwards, or a long way forwards */
+			_active.clear ();
+			_tree.at (t, _active);
+			_next = _tree.first_after (t);
+		} else {
+			/* Drop anything that has finished */
+			std::vector<size_t>::iterator j = _active.begin ();
+			for (std::vector<size_t>::const_iterator i = _active.begin(); i != _active.end(); ++i) {
+				if (t < _tree.to (*i)) {
+					*j++ = *i;
+				}
+			}
+			_active.erase (j, _active.end());
+
+			/* Add anything that has started */
+			while (_next < _tree.size() && !(t < _tree.from (_next))) {
+				if (t < _tree.to (_next)) {
+					_active.push_back (_next);
+				}
+				++_next;
+			}
+		}
+
+		_last = t;
+		return _active;
+	}
+
+	/** @return positions of the intervals which contain the last value that we moved to */
+	std::vector<size_t> const & active () const {
+		return _active;
+	}
+
+private:
+	/** Moving forward past more than this many intervals makes us use the tree
+	 *  rather than stepping through them.
+	 */
+	static size_t const seek_threshold = 64;
+
+	IntervalTree<T> const & _tree;
+	/** position of the first interval which has not started */
+	size_t _next;
+	/** positions of the intervals which contain _last, in ascending order */
+	std::vector<size_t> _active;
+	/** last value that we moved to */
+	boost::optional<T> _last;
+};
+
+}
+
+#endif
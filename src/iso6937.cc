@@ -21,6 +21,14 @@
 #include "iso6937.h"
 #include <boost/optional.hpp>
 #include <boost/locale.hpp>
+#include <stdint.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#include <cstring>
 #include <string>
 #include <iostream>
 
@@ -28,7 +36,6 @@ using std::string;
 using std::cout;
 using std::wcout;
 using std::wstring;
-using std::map;
 using boost::optional;
 using boost::locale::conv::utf_to_utf;
 using namespace sub;
@@ -36,10 +43,6 @@ using namespace sub;
 wstring
 sub::iso6937_to_utf16 (string s)
 {
-	if (iso6937::diacriticals.empty ()) {
-		make_iso6937_tables ();
-	}
-
 	wstring o;
 
 	boost::optional<unsigned char> diacritical;
@@ -47,10 +50,10 @@ sub::iso6937_to_utf16 (string s)
 	int i = 0;
 	while (s[i] != '\0') {
 		unsigned char const u = static_cast<unsigned char> (s[i]);
-		if (u >= 0xc1 && u <= 0xcf) {
+		if (u >= iso6937::first_diacritical && u <= iso6937::last_diacritical) {
 			diacritical = u;
 		} else if (diacritical) {
-			o += (*iso6937::diacriticals[diacritical.get()])[u];
+			o += iso6937::diacriticals[diacritical.get() - iso6937::first_diacritical][u];
 			diacritical.reset ();
 		} else {
 			o += iso6937::main[u];
@@ -62,59 +65,162 @@ sub::iso6937_to_utf16 (string s)
 	return o;
 }
 
-static optional<char>
-find (map<char, wchar_t> const & m, wchar_t c)
+/** @return true if all n bytes from p are printable ASCII (0x20 to 0x7e), which are
+ *  the same in ISO 6937 and UTF-8.
+ */
+static inline bool
+printable_ascii (unsigned char const * p, size_t n)
 {
-	for (map<char, wchar_t>::const_iterator i = m.begin(); i != m.end(); ++i) {
-		if (i->second == c) {
-			return i->first;
+	for (size_t i = 0; i < n; ++i) {
+		if (p[i] < 0x20 || p[i] > 0x7e) {
+			return false;
 		}
 	}
+	return true;
+}
 
-	return optional<char> ();
+/** @return the length of the run of printable ASCII starting at p, looking at no more than n bytes */
+static inline size_t
+printable_ascii_run (unsigned char const * p, size_t n)
+{
+	size_t i = 0;
+
+#ifdef __AVX2__
+	__m256i const space_minus_one = _mm256_set1_epi8 (0x1f);
+	__m256i const del = _mm256_set1_epi8 (0x7f);
+	while (i + 32 <= n) {
+		__m256i const v = _mm256_loadu_si256 (reinterpret_cast<__m256i const *> (p + i));
+		/* These comparisons are signed, so bytes of 0x80 and above fail the first one */
+		__m256i const ok = _mm256_and_si256 (_mm256_cmpgt_epi8 (v, space_minus_one), _mm256_cmpgt_epi8 (del, v));
+		if (static_cast<uint32_t> (_mm256_movemask_epi8 (ok)) != 0xffffffff) {
+			break;
+		}
+		i += 32;
+	}
+#endif
+
+#ifdef __SSE2__
+	__m128i const space_minus_one_128 = _mm_set1_epi8 (0x1f);
+	__m128i const del_128 = _mm_set1_epi8 (0x7f);
+	while (i + 16 <= n) {
+		__m128i const v = _mm_loadu_si128 (reinterpret_cast<__m128i const *> (p + i));
+		__m128i const ok = _mm_and_si128 (_mm_cmpgt_epi8 (v, space_minus_one_128), _mm_cmplt_epi8 (v, del_128));
+		if (_mm_movemask_epi8 (ok) != 0xffff) {
+			break;
+		}
+		i += 16;
+	}
+#else
+	while (i + 8 <= n && printable_ascii (p + i, 8)) {
+		i += 8;
+	}
+#endif
+
+	while (i < n && p[i] >= 0x20 && p[i] <= 0x7e) {
+		++i;
+	}
+
+	return i;
 }
 
-string
-sub::utf16_to_iso6937 (wstring s)
+/** Write c as UTF-8 to o.
+ *  @return the byte after the last one written.
+ */
+static inline char *
+put_utf8 (char* o, wchar_t c)
+{
+	if (c < 0x80) {
+		*o++ = c;
+	} else if (c < 0x800) {
+		*o++ = 0xc0 | (c >> 6);
+		*o++ = 0x80 | (c & 0x3f);
+	} else {
+		/* All the codes in the tables are in the BMP */
+		*o++ = 0xe0 | (c >> 12);
+		*o++ = 0x80 | ((c >> 6) & 0x3f);
+		*o++ = 0x80 | (c & 0x3f);
+	}
+	return o;
+}
+
+/** Decode ISO 6937 to UTF-8 in one pass, appending the result to out.
+ *  Unlike iso6937_to_utf16, this does not stop at a zero byte, and bytes
+ *  (or pairs of bytes) with no UTF-16 equivalent are skipped rather than
+ *  being decoded to U+0000.
+ */
+void
+sub::iso6937_to_utf8 (char const * data, size_t size, string& out)
 {
-	if (iso6937::diacriticals.empty ()) {
-		make_iso6937_tables ();
+	if (size == 0) {
+		return;
+	}
+
+	/* Each byte gives at most 3 bytes of UTF-8 */
+	size_t const start = out.size ();
+	out.resize (start + size * 3);
+	char* o = &out[0] + start;
+
+	unsigned char const * p = reinterpret_cast<unsigned char const *> (data);
+	unsigned char const * const end = p + size;
+	while (p < end) {
+		size_t const run = printable_ascii_run (p, end - p);
+		memcpy (o, p, run);
+		o += run;
+		p += run;
+		if (p == end) {
+			break;
+		}
+
+		wchar_t c;
+		if (*p >= iso6937::first_diacritical && *p <= iso6937::last_diacritical) {
+			if (p + 1 == end) {
+				break;
+			}
+			if (p[1] >= iso6937::first_diacritical && p[1] <= iso6937::last_diacritical) {
+				/* As in iso6937_to_utf16, the second of two diacritical bytes is the one that counts */
+				++p;
+				continue;
+			}
+			c = iso6937::diacriticals[p[0] - iso6937::first_diacritical][p[1]];
+			p += 2;
+		} else {
+			c = iso6937::main[*p];
+			++p;
+		}
+
+		if (c) {
+			o = put_utf8 (o, c);
+		}
 	}
 
-	/* XXX: slow */
+	out.resize (o - &out[0]);
+}
 
+string
+sub::iso6937_to_utf8 (char const * data, size_t size)
+{
+	string out;
+	iso6937_to_utf8 (data, size, out);
+	return out;
+}
+
+string
+sub::utf16_to_iso6937 (wstring s)
+{
 	string o;
+	o.reserve (s.size ());
 	for (size_t i = 0; i < s.size(); ++i) {
-		optional<char> c = find (iso6937::main, s[i]);
-		if (c) {
-			o += c.get ();
-		} else {
-			for (map<char, map<char, wchar_t> *>::const_iterator j = iso6937::diacriticals.begin(); j != iso6937::diacriticals.end(); ++j) {
-				c = find (*(j->second), s[i]);
-				if (c) {
-					o += j->first;
-					o += c.get ();
-					break;
-				}
-			}
+		uint32_t const c = s[i];
+		if (c >= iso6937::encode_size) {
+			continue;
 		}
 
-		if (s[i] == 0x201e) {
-			/* ISO6397 does not support German (lower) quotation mark (UTF 0x201e) so use
-			   a normal opening one (0x201c, which is 170 in ISO6937).
-			*/
-			o += (char) 170;
-		} else if (s[i] == 0x2013 || s[i] == 0x2014) {
-			/* ISO6397 does not support en- or em-dashes, so use a horizontal bar (0x2015,
-			   which is 208 in ISO6937).
-			*/
-			o += (char) 208;
-		} else if (s[i] == 0x2010 || s[i] == 0x2011 || s[i] == 0x2012) {
-			/* Similar story with hyphen, non-breaking hyphen, figure dash */
-			o += '-';
-		} else if (s[i] == 0x2032) {
-			/* And prime */
-			o += '\'';
+		uint16_t const code = iso6937::encode[c];
+		if (code > 0xff) {
+			o += static_cast<char> (code >> 8);
+			o += static_cast<char> (code & 0xff);
+		} else if (code) {
+			o += static_cast<char> (code);
 		}
 	}
 
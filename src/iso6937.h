@@ -18,10 +18,13 @@
 */
 
 #include <iostream>
+#include <string>
 
 namespace sub {
 
 extern std::wstring iso6937_to_utf16 (std::string);
 extern std::string utf16_to_iso6937 (std::wstring);
+extern void iso6937_to_utf8 (char const * data, size_t size, std::string& out);
+extern std::string iso6937_to_utf8 (char const * data, size_t size);
 
 };
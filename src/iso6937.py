@@ -4,8 +4,11 @@ import sys
 DATA = 'http://www.unicode.org/Public/6.0.0/ucd/UnicodeData.txt'
 OUTPUT = 'src/iso6937_tables'
 
-data = urllib2.urlopen(DATA).read()
-# data = open('UnicodeData.txt').read()
+# A local copy of UnicodeData.txt may be given as the first argument
+if len(sys.argv) > 1:
+    data = open(sys.argv[1]).read()
+else:
+    data = urllib2.urlopen(DATA).read()
 output_c = open(OUTPUT + '.cc', 'w')
 output_h = open(OUTPUT + '.h', 'w')
 
@@ -13,57 +16,16 @@ def find_unicode(n):
     for line in iter(data.splitlines()):
         s = line.split(';')
         if s[1] == n:
-            return s[0]
+            return int(s[0], 16)
 
     print 'Could not find %s' % n
     sys.exit(1)
 
-def setup(output_diacritical_name):
-    print>>output_c,'map<char, wchar_t> sub::iso6937::%s;' % output_diacritical_name
+def print_array(values, width, per_line):
+    for i in range(0, len(values), per_line):
+        print>>output_c,'\t' + ' '.join(['0x%0*X,' % (width, v) for v in values[i:i + per_line]])
 
-def fill(unicode_diacritical_name, output_diacritical_name, letters):
-
-    print>>output_h,'extern std::map<char, wchar_t> %s;' % output_diacritical_name
-
-    for letter in letters:
-        if letter.isupper():
-            case = 'CAPITAL'
-        else:
-            case = 'SMALL'
-
-        unicode_name = 'LATIN %s LETTER %s WITH %s' % (case, letter.upper(), unicode_diacritical_name)
-        print>>output_c,"\t%s['%s'] = 0x%s;" % (output_diacritical_name, letter, find_unicode(unicode_name))
-
-    print>>output_c,""
-
-print>>output_c,"""/*
-    Copyright (C) 2014 Carl Hetherington <cth@carlh.net>
-
-    This program is free software; you can redistribute it and/or modify
-    it under the terms of the GNU General Public License as published by
-    the Free Software Foundation; either version 2 of the License, or
-    (at your option) any later version.
-
-    This program is distributed in the hope that it will be useful,
-    but WITHOUT ANY WARRANTY; without even the implied warranty of
-    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-    GNU General Public License for more details.
-
-    You should have received a copy of the GNU General Public License
-    along with this program; if not, write to the Free Software
-    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
-
-*/
-
-/* THIS FILE WAS AUTO-GENERATED BY iso6937.py */
-
-#include <map>
-#include "iso6937_tables.h"
-
-using std::map;
-"""
-
-print>>output_h,"""/*
+LICENCE = """/*
     Copyright (C) 2014 Carl Hetherington <cth@carlh.net>
 
     This program is free software; you can redistribute it and/or modify
@@ -80,18 +42,7 @@ print>>output_h,"""/*
     along with this program; if not, write to the Free Software
     Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 
-*/
-
-/* THIS FILE WAS AUTO-GENERATED BY iso6937.py */
-
-#include <map>
-
-namespace sub {
-
-extern void make_iso6937_tables ();
-
-namespace iso6937 {
-"""
+*/"""
 
 groups = [
     (0xC1, 'GRAVE', 'grave', 'AEIOUaeiou'),
@@ -109,128 +60,215 @@ groups = [
     (0xCF, 'CARON', 'caron', 'CDELNRSTZcdelnrstz')
 ]
 
-for g in groups:
-    setup(g[2])
+FIRST_DIACRITICAL = 0xC1
+LAST_DIACRITICAL = 0xCF
 
-print>>output_c,"map<char, wchar_t> sub::iso6937::main;"
-print>>output_c,"map<char, map<char, wchar_t> *> sub::iso6937::diacriticals;"
-print>>output_h,"extern std::map<char, wchar_t> main;"
-print>>output_h,"extern std::map<char, std::map<char, wchar_t> *> diacriticals;"
+# UTF-16 code of each single-byte character
+main = [0] * 256
 
-print>>output_c,"""
-void
-sub::make_iso6937_tables ()
-{
-\tusing namespace sub::iso6937;
-"""
-
-for g in groups:
-    fill(g[1], g[2], g[3])
-
-print>>output_c,"\tmain[10] = 0x000A;"
+main[10] = 0x000A
 
 for i in range(32, 127):
-    if chr(i) == "'" or chr(i) == "\\":
-        print>>output_c,"\tmain['\\%s'] = 0x00%x;" % (chr(i), i)
-    else:
-        print>>output_c,"\tmain['%s'] = 0x00%x;" % (chr(i), i)
+    main[i] = i
 
 # From Wikipedia
 # http://en.wikipedia.org/wiki/ISO/IEC_6937
-print>>output_c,"\tmain[161] = 0x00A1;"
-print>>output_c,"\tmain[162] = 0x00A2;"
-print>>output_c,"\tmain[163] = 0x00A3;"
+main[161] = 0x00A1
+main[162] = 0x00A2
+main[163] = 0x00A3
 # Wikipedia says the dollar is 0x24, but Annotation
 # Edit (and some other sources) disagree.
-print>>output_c,"\tmain[164] = 0x0024;"
-print>>output_c,"\tmain[165] = 0x00A5;"
-print>>output_c,"\tmain[167] = 0x00A7;"
-print>>output_c,"\tmain[168] = 0x00A4;"
-print>>output_c,"\tmain[169] = 0x2018;"
-print>>output_c,"\tmain[170] = 0x201C;"
-print>>output_c,"\tmain[171] = 0x00AB;"
-print>>output_c,"\tmain[172] = 0x2190;"
-print>>output_c,"\tmain[173] = 0x2191;"
-print>>output_c,"\tmain[174] = 0x2192;"
-print>>output_c,"\tmain[175] = 0x2193;"
-print>>output_c,"\tmain[176] = 0x00B0;"
-print>>output_c,"\tmain[177] = 0x00B1;"
-print>>output_c,"\tmain[178] = 0x00B2;"
-print>>output_c,"\tmain[179] = 0x00B3;"
-print>>output_c,"\tmain[180] = 0x00D7;"
-print>>output_c,"\tmain[181] = 0x00B5;"
-print>>output_c,"\tmain[182] = 0x00B6;"
-print>>output_c,"\tmain[183] = 0x00B7;"
-print>>output_c,"\tmain[184] = 0x00F7;"
-print>>output_c,"\tmain[185] = 0x2019;"
-print>>output_c,"\tmain[186] = 0x201D;"
-print>>output_c,"\tmain[187] = 0x00BB;"
-print>>output_c,"\tmain[188] = 0x00BC;"
-print>>output_c,"\tmain[189] = 0x00BD;"
-print>>output_c,"\tmain[190] = 0x00BE;"
-print>>output_c,"\tmain[191] = 0x00BF;"
-print>>output_c,"\tmain[193] = 0x0300;"
-print>>output_c,"\tmain[194] = 0x0301;"
-print>>output_c,"\tmain[195] = 0x0302;"
-print>>output_c,"\tmain[196] = 0x0303;"
-print>>output_c,"\tmain[197] = 0x0304;"
-print>>output_c,"\tmain[198] = 0x0306;"
-print>>output_c,"\tmain[199] = 0x0307;"
-print>>output_c,"\tmain[200] = 0x0308;"
-print>>output_c,"\tmain[202] = 0x030A;"
-print>>output_c,"\tmain[203] = 0x0327;"
-print>>output_c,"\tmain[205] = 0x030B;"
-print>>output_c,"\tmain[206] = 0x032B;"
-print>>output_c,"\tmain[207] = 0x030C;"
-print>>output_c,"\tmain[208] = 0x2015;"
-print>>output_c,"\tmain[209] = 0x00B9;"
-print>>output_c,"\tmain[210] = 0x00AE;"
-print>>output_c,"\tmain[211] = 0x00A9;"
-print>>output_c,"\tmain[212] = 0x2122;"
-print>>output_c,"\tmain[213] = 0x266A;"
-print>>output_c,"\tmain[214] = 0x00AC;"
-print>>output_c,"\tmain[215] = 0x00A6;"
-print>>output_c,"\tmain[220] = 0x215B;"
-print>>output_c,"\tmain[221] = 0x215C;"
-print>>output_c,"\tmain[222] = 0x215D;"
-print>>output_c,"\tmain[223] = 0x215E;"
-print>>output_c,"\tmain[224] = 0x2126;"
-print>>output_c,"\tmain[225] = 0x00C6;"
-print>>output_c,"\tmain[226] = 0x0110;"
-print>>output_c,"\tmain[227] = 0x00AA;"
-print>>output_c,"\tmain[228] = 0x0126;"
-print>>output_c,"\tmain[230] = 0x0132;"
-print>>output_c,"\tmain[231] = 0x013F;"
-print>>output_c,"\tmain[232] = 0x0141;"
-print>>output_c,"\tmain[233] = 0x00D8;"
-print>>output_c,"\tmain[234] = 0x0152;"
-print>>output_c,"\tmain[235] = 0x00BA;"
-print>>output_c,"\tmain[236] = 0x00DE;"
-print>>output_c,"\tmain[237] = 0x0166;"
-print>>output_c,"\tmain[238] = 0x014A;"
-print>>output_c,"\tmain[239] = 0x0149;"
-print>>output_c,"\tmain[240] = 0x0138;"
-print>>output_c,"\tmain[241] = 0x00E6;"
-print>>output_c,"\tmain[242] = 0x0111;"
-print>>output_c,"\tmain[243] = 0x00F0;"
-print>>output_c,"\tmain[244] = 0x0127;"
-print>>output_c,"\tmain[245] = 0x0131;"
-print>>output_c,"\tmain[246] = 0x0133;"
-print>>output_c,"\tmain[247] = 0x0140;"
-print>>output_c,"\tmain[248] = 0x0142;"
-print>>output_c,"\tmain[249] = 0x00F8;"
-print>>output_c,"\tmain[250] = 0x0153;"
-print>>output_c,"\tmain[251] = 0x00DF;"
-print>>output_c,"\tmain[252] = 0x00FE;"
-print>>output_c,"\tmain[253] = 0x0167;"
-print>>output_c,"\tmain[254] = 0x014B;"
-print>>output_c,"\tmain[255] = 0x00AD;"
-print>>output_c,""
+main[164] = 0x0024
+main[165] = 0x00A5
+main[167] = 0x00A7
+main[168] = 0x00A4
+main[169] = 0x2018
+main[170] = 0x201C
+main[171] = 0x00AB
+main[172] = 0x2190
+main[173] = 0x2191
+main[174] = 0x2192
+main[175] = 0x2193
+main[176] = 0x00B0
+main[177] = 0x00B1
+main[178] = 0x00B2
+main[179] = 0x00B3
+main[180] = 0x00D7
+main[181] = 0x00B5
+main[182] = 0x00B6
+main[183] = 0x00B7
+main[184] = 0x00F7
+main[185] = 0x2019
+main[186] = 0x201D
+main[187] = 0x00BB
+main[188] = 0x00BC
+main[189] = 0x00BD
+main[190] = 0x00BE
+main[191] = 0x00BF
+main[193] = 0x0300
+main[194] = 0x0301
+main[195] = 0x0302
+main[196] = 0x0303
+main[197] = 0x0304
+main[198] = 0x0306
+main[199] = 0x0307
+main[200] = 0x0308
+main[202] = 0x030A
+main[203] = 0x0327
+main[205] = 0x030B
+main[206] = 0x032B
+main[207] = 0x030C
+main[208] = 0x2015
+main[209] = 0x00B9
+main[210] = 0x00AE
+main[211] = 0x00A9
+main[212] = 0x2122
+main[213] = 0x266A
+main[214] = 0x00AC
+main[215] = 0x00A6
+main[220] = 0x215B
+main[221] = 0x215C
+main[222] = 0x215D
+main[223] = 0x215E
+main[224] = 0x2126
+main[225] = 0x00C6
+main[226] = 0x0110
+main[227] = 0x00AA
+main[228] = 0x0126
+main[230] = 0x0132
+main[231] = 0x013F
+main[232] = 0x0141
+main[233] = 0x00D8
+main[234] = 0x0152
+main[235] = 0x00BA
+main[236] = 0x00DE
+main[237] = 0x0166
+main[238] = 0x014A
+main[239] = 0x0149
+main[240] = 0x0138
+main[241] = 0x00E6
+main[242] = 0x0111
+main[243] = 0x00F0
+main[244] = 0x0127
+main[245] = 0x0131
+main[246] = 0x0133
+main[247] = 0x0140
+main[248] = 0x0142
+main[249] = 0x00F8
+main[250] = 0x0153
+main[251] = 0x00DF
+main[252] = 0x00FE
+main[253] = 0x0167
+main[254] = 0x014B
+main[255] = 0x00AD
+
+# UTF-16 code of each letter after each diacritical byte
+diacriticals = [[0] * 256 for i in range(FIRST_DIACRITICAL, LAST_DIACRITICAL + 1)]
 
 for g in groups:
-    print>>output_c,"\tdiacriticals[%s] = &%s;" % (hex(g[0]), g[2])
+    for letter in g[3]:
+        if letter.isupper():
+            case = 'CAPITAL'
+        else:
+            case = 'SMALL'
+
+        unicode_name = 'LATIN %s LETTER %s WITH %s' % (case, letter.upper(), g[1])
+        diacriticals[g[0] - FIRST_DIACRITICAL][ord(letter)] = find_unicode(unicode_name)
+
+# Encoding of each UTF-16 code, with the first byte of two-byte encodings in the top 8 bits
+encode_size = max(main + [max(d) for d in diacriticals]) + 1
+encode = [0] * encode_size
+
+def add_encoding(code, encoding):
+    if encode[code] == 0:
+        encode[code] = encoding
+
+# Where a code has two single-byte encodings (only the dollar) use the upper one
+for i in range(128, 256) + range(0, 128):
+    if main[i] != 0:
+        add_encoding(main[i], i)
+
+for g in groups:
+    for letter in sorted(g[3]):
+        add_encoding(diacriticals[g[0] - FIRST_DIACRITICAL][ord(letter)], (g[0] << 8) | ord(letter))
+
+# ISO6397 does not support German (lower) quotation mark (UTF 0x201e) so use
+# a normal opening one (0x201c, which is 170 in ISO6937).
+add_encoding(0x201E, 170)
+# ISO6397 does not support en- or em-dashes, so use a horizontal bar (0x2015,
+# which is 208 in ISO6937).
+add_encoding(0x2013, 208)
+add_encoding(0x2014, 208)
+# Similar story with hyphen, non-breaking hyphen, figure dash
+add_encoding(0x2010, ord('-'))
+add_encoding(0x2011, ord('-'))
+add_encoding(0x2012, ord('-'))
+# And prime
+add_encoding(0x2032, ord("'"))
+
+print>>output_c,LICENCE
+print>>output_c,"""
+/* THIS FILE WAS AUTO-GENERATED BY iso6937.py */
+
+#include "iso6937_tables.h"
+"""
+
+print>>output_c,"wchar_t const sub::iso6937::main[256] = {"
+print_array(main, 4, 8)
+print>>output_c,"};"
+print>>output_c,""
+
+print>>output_c,"wchar_t const sub::iso6937::diacriticals[%d][256] = {" % (LAST_DIACRITICAL - FIRST_DIACRITICAL + 1)
+for i in range(FIRST_DIACRITICAL, LAST_DIACRITICAL + 1):
+    names = [g[2] for g in groups if g[0] == i]
+    if names:
+        print>>output_c,"\t/* 0x%X: %s */" % (i, names[0])
+    else:
+        print>>output_c,"\t/* 0x%X: unused */" % i
+    print>>output_c,"\t{"
+    print_array(diacriticals[i - FIRST_DIACRITICAL], 4, 8)
+    print>>output_c,"\t},"
+print>>output_c,"};"
+print>>output_c,""
+
+print>>output_c,"uint16_t const sub::iso6937::encode[0x%X] = {" % encode_size
+print_array(encode, 4, 16)
+print>>output_c,"};"
+
+print>>output_h,LICENCE
+print>>output_h,"""
+/* THIS FILE WAS AUTO-GENERATED BY iso6937.py */
+
+#ifndef LIBSUB_ISO6937_TABLES_H
+#define LIBSUB_ISO6937_TABLES_H
+
+#include <stdint.h>
+
+namespace sub {
+
+namespace iso6937 {
+
+/** UTF-16 code of each single-byte character, or 0 */
+extern wchar_t const main[256];
+
+/** First byte of the two-byte characters with diacritical marks */
+static unsigned char const first_diacritical = 0x%X;
+/** Last byte of the two-byte characters with diacritical marks */
+static unsigned char const last_diacritical = 0x%X;
+/** UTF-16 code of each two-byte character, or 0, indexed by its first byte
+ *  minus first_diacritical and then by its second byte.
+ */
+extern wchar_t const diacriticals[%d][256];
+
+/** One past the highest UTF-16 code that can be encoded */
+static uint32_t const encode_size = 0x%X;
+/** Encoding of each UTF-16 code below encode_size: its single byte, or its first byte
+ *  shifted left by 8 and ORed with its second byte, or 0 if it cannot be encoded.
+ */
+extern uint16_t const encode[encode_size];
+
+}
+
+}
 
-print>>output_c,"}"
-print>>output_h,""
-print>>output_h,"}"
-print>>output_h,"}"
+#endif""" % (FIRST_DIACRITICAL, LAST_DIACRITICAL, LAST_DIACRITICAL - FIRST_DIACRITICAL + 1, encode_size)
@@ -19,29 +19,36 @@
 
 /* THIS FILE WAS AUTO-GENERATED BY iso6937.py */
 
-#include <map>
+#ifndef LIBSUB_ISO6937_TABLES_H
+#define LIBSUB_ISO6937_TABLES_H
 
-namespace sub {
+#include <stdint.h>
 
-extern void make_iso6937_tables ();
+namespace sub {
 
 namespace iso6937 {
 
-extern std::map<char, wchar_t> main;
-extern std::map<char, std::map<char, wchar_t> *> diacriticals;
-extern std::map<char, wchar_t> grave;
-extern std::map<char, wchar_t> acute;
-extern std::map<char, wchar_t> circumflex;
-extern std::map<char, wchar_t> tilde;
-extern std::map<char, wchar_t> macron;
-extern std::map<char, wchar_t> breve;
-extern std::map<char, wchar_t> dot;
-extern std::map<char, wchar_t> diaeresis;
-extern std::map<char, wchar_t> ring;
-extern std::map<char, wchar_t> cedilla;
-extern std::map<char, wchar_t> double_acute;
-extern std::map<char, wchar_t> ogonek;
-extern std::map<char, wchar_t> caron;
+/** UTF-16 code of each single-byte character, or 0 */
+extern wchar_t const main[256];
+
+/** First byte of the two-byte characters with diacritical marks */
+static unsigned char const first_diacritical = 0xC1;
+/** Last byte of the two-byte characters with diacritical marks */
+static unsigned char const last_diacritical = 0xCF;
+/** UTF-16 code of each two-byte character, or 0, indexed by its first byte
+ *  minus first_diacritical and then by its second byte.
+ */
+extern wchar_t const diacriticals[15][256];
+
+/** One past the highest UTF-16 code that can be encoded */
+static uint32_t const encode_size = 0x266B;
+/** Encoding of each UTF-16 code below encode_size: its single byte, or its first byte
+ *  shifted left by 8 and ORed with its second byte, or 0 if it cannot be encoded.
+ */
+extern uint16_t const encode[encode_size];
 
 }
+
 }
+
+#endif
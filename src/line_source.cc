@@ -0,0 +1,136 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  src/line_source.cc
+ *  @brief LineView class and sources of lines for the text-based readers.
+ */
+
+#include "line_source.h"
+#include <cstring>
+
+using std::istream;
+using namespace sub;
+
+/** Size of the initial buffer for a BufferedLineSource; it will grow if a line is longer than this */
+static size_t const buffer_size = 65536;
+
+bool
+LineView::starts_with (char const * s) const
+{
+	size_t const n = strlen (s);
+	return _size >= n && memcmp (_data, s, n) == 0;
+}
+
+bool
+LineView::operator== (char const * s) const
+{
+	return _size == strlen (s) && memcmp (_data, s, _size) == 0;
+}
+
+void
+LineView::remove_prefix (size_t n)
+{
+	_data += n;
+	_size -= n;
+}
+
+/** Remove any characters in chars from the end of this view */
+void
+LineView::trim_right (char const * chars)
+{
+	while (_size > 0 && strchr (chars, _data[_size - 1])) {
+		--_size;
+	}
+}
+
+/** Remove white space (as boost::algorithm::trim would in the C locale) from both ends of this view */
+void
+LineView::trim ()
+{
+	char const * space = " \t\n\v\f\r";
+	while (_size > 0 && strchr (space, _data[0])) {
+		++_data;
+		--_size;
+	}
+	trim_right (space);
+}
+
+BufferedLineSource::BufferedLineSource ()
+	: _buffer (buffer_size)
+	, _begin (0)
+	, _end (0)
+	, _eof (false)
+{
+
+}
+
+/** Called when there is no complete line left in _buffer */
+bool
+BufferedLineSource::refill_and_get (LineView& line)
+{
+	while (true) {
+		if (_eof) {
+			if (_begin == _end) {
+				return false;
+			}
+			/* Last line, with no terminator */
+			line = LineView (&_buffer[0] + _begin, _end - _begin);
+			_begin = _end;
+			return true;
+		}
+
+		/* Move the start of the incomplete line to the start of the buffer, and
+		   make the buffer bigger if that line already fills it.
+		*/
+		size_t const have = _end - _begin;
+		memmove (&_buffer[0], &_buffer[0] + _begin, have);
+		_begin = 0;
+		_end = have;
+		if (_end == _buffer.size ()) {
+			_buffer.resize (_buffer.size() * 2);
+		}
+
+		size_t const r = read (&_buffer[0] + _end, _buffer.size() - _end);
+		if (r == 0) {
+			_eof = true;
+			continue;
+		}
+
+		char const * n = static_cast<char const *> (memchr (&_buffer[0] + _end, '\n', r));
+		_end += r;
+		if (n) {
+			line = LineView (&_buffer[0], n - &_buffer[0]);
+			_begin = n - &_buffer[0] + 1;
+			return true;
+		}
+	}
+}
+
+size_t
+FileLineSource::read (char* p, size_t n)
+{
+	return fread (p, 1, n, _file);
+}
+
+size_t
+StreamLineSource::read (char* p, size_t n)
+{
+	_stream.read (p, n);
+	return _stream.gcount ();
+}
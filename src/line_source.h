@@ -0,0 +1,259 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  src/line_source.h
+ *  @brief LineView class and sources of lines for the text-based readers.
+ */
+
+#ifndef LIBSUB_LINE_SOURCE_H
+#define LIBSUB_LINE_SOURCE_H
+
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace sub {
+
+/** @class LineView
+ *  @brief A piece of text which points into a buffer owned by someone else.
+ */
+class LineView
+{
+public:
+	LineView ()
+		: _data (0)
+		, _size (0)
+	{}
+
+	LineView (char const * data, size_t size)
+		: _data (data)
+		, _size (size)
+	{}
+
+	/** @param s Zero-terminated string, which must outlive this object */
+	LineView (char const * s)
+		: _data (s)
+		, _size (strlen (s))
+	{}
+
+	char const * data () const {
+		return _data;
+	}
+
+	size_t size () const {
+		return _size;
+	}
+
+	bool empty () const {
+		return _size == 0;
+	}
+
+	char operator[] (size_t i) const {
+		return _data[i];
+	}
+
+	std::string to_string () const {
+		return std::string (_data, _size);
+	}
+
+	bool starts_with (char const * s) const;
+	bool operator== (char const * s) const;
+
+	void remove_prefix (size_t n);
+	void trim_right (char const * chars);
+	void trim ();
+
+private:
+	char const * _data;
+	size_t _size;
+};
+
+/** @class BufferLineSource
+ *  @brief Lines from a buffer in memory, which must outlive this object.
+ *
+ *  Lines are returned without their terminating \\n.
+ */
+class BufferLineSource
+{
+public:
+	BufferLineSource (char const * data, size_t size)
+		: _next (data)
+		, _end (data + size)
+	{}
+
+	/** @param line Filled in with the next line, which is valid for as long as the buffer is.
+	 *  @return false if there are no more lines.
+	 */
+	bool get (LineView& line) {
+		if (_next == _end) {
+			return false;
+		}
+
+		char const * n = static_cast<char const *> (memchr (_next, '\n', _end - _next));
+		if (!n) {
+			line = LineView (_next, _end - _next);
+			_next = _end;
+		} else {
+			line = LineView (_next, n - _next);
+			_next = n + 1;
+		}
+
+		return true;
+	}
+
+private:
+	char const * _next;
+	char const * _end;
+};
+
+/** @class BufferedLineSource
+ *  @brief Parent for sources which read lines into a buffer of their own in large chunks.
+ *
+ *  Lines are returned without their terminating \\n, and there is no limit on their length.
+ */
+class BufferedLineSource : public boost::noncopyable
+{
+public:
+	virtual ~BufferedLineSource () {}
+
+	/** @param line Filled in with the next line, which is valid until the next call to get().
+	 *  @return false if there are no more lines.
+	 */
+	bool get (LineView& line) {
+		char const * n = static_cast<char const *> (memchr (&_buffer[0] + _begin, '\n', _end - _begin));
+		if (!n) {
+			return refill_and_get (line);
+		}
+
+		line = LineView (&_buffer[0] + _begin, n - &_buffer[0] - _begin);
+		_begin = n - &_buffer[0] + 1;
+		return true;
+	}
+
+protected:
+	BufferedLineSource ();
+
+	/** Read up to n bytes into p.
+	 *  @return Number of bytes read; 0 means that the end of the input has been reached.
+	 */
+	virtual size_t read (char* p, size_t n) = 0;
+
+private:
+	bool refill_and_get (LineView& line);
+
+	std::vector<char> _buffer;
+	/** offset of the first unused byte in _buffer */
+	size_t _begin;
+	/** offset of the end of the valid data in _buffer */
+	size_t _end;
+	bool _eof;
+};
+
+/** @class FileLineSource
+ *  @brief Lines from a FILE*, which must stay open for the lifetime of this object.
+ */
+class FileLineSource : public BufferedLineSource
+{
+public:
+	explicit FileLineSource (FILE* file)
+		: _file (file)
+	{}
+
+private:
+	size_t read (char* p, size_t n);
+
+	FILE* _file;
+};
+
+/** @class StreamLineSource
+ *  @brief Lines from a std::istream, which must outlive this object.
+ */
+class StreamLineSource : public BufferedLineSource
+{
+public:
+	explicit StreamLineSource (std::istream& stream)
+		: _stream (stream)
+	{}
+
+private:
+	size_t read (char* p, size_t n);
+
+	std::istream& _stream;
+};
+
+/** @class ReaderLineSource
+ *  @brief A source of lines for a reader of type R.
+ *
+ *  The type of the underlying source is hidden behind one virtual call per
+ *  subtitle, rather than one per line; lines go from the source to
+ *  R::process_line() in a loop which the compiler can specialise for each
+ *  type of source.
+ */
+template <class R>
+class ReaderLineSource : public boost::noncopyable
+{
+public:
+	virtual ~ReaderLineSource () {}
+
+	/** Give lines to reader->process_line() until it says that it may have added a subtitle.
+	 *  @return false if the source ran out first.
+	 */
+	virtual bool read_more (R* reader) = 0;
+
+	/** Get one line outside of the read_more() loop, e.g. for the context of an error */
+	virtual bool get (LineView& line) = 0;
+};
+
+/** @class ReaderLineSourceImpl
+ *  @brief A ReaderLineSource for a reader of type R using a source of type S.
+ */
+template <class R, class S>
+class ReaderLineSourceImpl : public ReaderLineSource<R>
+{
+public:
+	/** @param source Source, which we will take ownership of */
+	explicit ReaderLineSourceImpl (S* source)
+		: _source (source)
+	{}
+
+	bool read_more (R* reader) {
+		LineView line;
+		while (_source->get (line)) {
+			if (reader->process_line (line)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool get (LineView& line) {
+		return _source->get (line);
+	}
+
+private:
+	boost::scoped_ptr<S> _source;
+};
+
+}
+
+#endif
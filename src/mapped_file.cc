@@ -0,0 +1,94 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  src/mapped_file.cc
+ *  @brief MappedFile class.
+ */
+
+#include "mapped_file.h"
+#include "exceptions.h"
+#include "compose.hpp"
+#ifdef LIBSUB_POSIX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include <cstdio>
+
+using namespace sub;
+
+MappedFile::MappedFile (boost::filesystem::path file, Access access)
+	: _data (0)
+	, _size (0)
+{
+#ifdef LIBSUB_POSIX
+	int const fd = open (file.string().c_str(), O_RDONLY);
+	if (fd == -1) {
+		throw FileError (String::compose ("Could not open %1", file.string()));
+	}
+
+	struct stat s;
+	if (fstat (fd, &s) == -1) {
+		close (fd);
+		throw FileError (String::compose ("Could not find the size of %1", file.string()));
+	}
+
+	_size = s.st_size;
+	if (_size > 0) {
+		void* p = mmap (0, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (p == MAP_FAILED) {
+			close (fd);
+			throw FileError (String::compose ("Could not map %1", file.string()));
+		}
+		_data = static_cast<char*> (p);
+		madvise (p, _size, access == SEQUENTIAL ? MADV_SEQUENTIAL : MADV_RANDOM);
+	}
+
+	/* The mapping stays valid after the descriptor is closed */
+	close (fd);
+#else
+	FILE* f = fopen (file.string().c_str(), "rb");
+	if (!f) {
+		throw FileError (String::compose ("Could not open %1", file.string()));
+	}
+
+	_size = boost::filesystem::file_size (file);
+	if (_size > 0) {
+		_data = new char[_size];
+		if (fread (_data, 1, _size, f) != _size) {
+			delete[] _data;
+			fclose (f);
+			throw FileError (String::compose ("Could not read %1", file.string()));
+		}
+	}
+	fclose (f);
+#endif
+}
+
+MappedFile::~MappedFile ()
+{
+#ifdef LIBSUB_POSIX
+	if (_data) {
+		munmap (_data, _size);
+	}
+#else
+	delete[] _data;
+#endif
+}
@@ -0,0 +1,66 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  src/mapped_file.h
+ *  @brief MappedFile class.
+ */
+
+#ifndef LIBSUB_MAPPED_FILE_H
+#define LIBSUB_MAPPED_FILE_H
+
+#include <boost/filesystem.hpp>
+#include <boost/noncopyable.hpp>
+
+namespace sub {
+
+/** @class MappedFile
+ *  @brief The contents of a file, mapped into memory.
+ *
+ *  On platforms without mmap() the file is read into memory instead.
+ */
+class MappedFile : public boost::noncopyable
+{
+public:
+	/** How the file will be read, as a hint to the operating system */
+	enum Access {
+		/** from start to finish */
+		SEQUENTIAL,
+		/** in no particular order */
+		RANDOM
+	};
+
+	explicit MappedFile (boost::filesystem::path file, Access access = SEQUENTIAL);
+	~MappedFile ();
+
+	char const * data () const {
+		return _data;
+	}
+
+	size_t size () const {
+		return _size;
+	}
+
+private:
+	char* _data;
+	size_t _size;
+};
+
+}
+
+#endif
@@ -0,0 +1,116 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  src/playback_cursor.cc
+ *  @brief PlaybackCursor class.
+ */
+
+#include "playback_cursor.h"
+#include "timeline.h"
+#include "sub_assert.h"
+#include <algorithm>
+
+using std::vector;
+using namespace sub;
+
+/** @param timeline Timeline of the subtitles, which must outlive this object.
+ *  @param rate Video frame rate, which must be integer.
+ */
+PlaybackCursor::PlaybackCursor (Timeline const & timeline, Rational rate)
+	: _timeline (timeline)
+	, _fps (rate.integer_fraction ())
+	, _cursor (_tree)
+{
+	SUB_ASSERT (rate.denominator != 0);
+	SUB_ASSERT (rate.integer ());
+
+	/* frame() never puts times in a different order, so giving our tree the frames in the
+	   timeline's sorted order means that its positions are the same as the timeline's.
+	*/
+	IntervalTree<Time> const & times = timeline.tree ();
+	vector<int64_t> from (times.size ());
+	vector<int64_t> to (times.size ());
+	for (size_t i = 0; i < times.size(); ++i) {
+		from[i] = frame (times.from (i));
+		to[i] = frame (times.to (i));
+	}
+
+	_tree.build (from, to);
+}
+
+/** @return frame that a time is in, counting from zero at our rate */
+int64_t
+PlaybackCursor::frame (Time const & t) const
+{
+	int64_t const seconds = int64_t (t.hours()) * 3600 + t.minutes() * 60 + t.seconds();
+	return seconds * _fps + t.frames_at (Rational (_fps, 1));
+}
+
+/** Move to a time, as for move (int64_t) */
+vector<PlaybackEvent> const &
+PlaybackCursor::move (Time const & t)
+{
+	return move (frame (t));
+}
+
+/** Move to a frame.
+ *  @return What happened to get from the last frame to this one: subtitles leaving the screen,
+ *  then subtitles arriving, each in order of from time.  This is valid until the next call to move().
+ */
+vector<PlaybackEvent> const &
+PlaybackCursor::move (int64_t frame)
+{
+	_events.clear ();
+
+	_previous = _cursor.active ();
+	vector<size_t> const & active = _cursor.move (frame);
+
+	/* Both lists are sorted, so we can find what has gone and what has arrived by searching them */
+	for (vector<size_t>::const_iterator i = _previous.begin(); i != _previous.end(); ++i) {
+		if (!std::binary_search (active.begin(), active.end(), *i)) {
+			_events.push_back (PlaybackEvent (PlaybackEvent::EXIT, index (*i)));
+		}
+	}
+
+	for (vector<size_t>::const_iterator i = active.begin(); i != active.end(); ++i) {
+		if (!std::binary_search (_previous.begin(), _previous.end(), *i)) {
+			_events.push_back (PlaybackEvent (PlaybackEvent::ENTER, index (*i)));
+		}
+	}
+
+	update_on_screen ();
+	return _events;
+}
+
+/** @return index in the timeline of the subtitle at a position in our tree */
+size_t
+PlaybackCursor::index (size_t position) const
+{
+	return _timeline.tree().index (position);
+}
+
+void
+PlaybackCursor::update_on_screen ()
+{
+	_on_screen.clear ();
+	vector<size_t> const & active = _cursor.active ();
+	for (vector<size_t>::const_iterator i = active.begin(); i != active.end(); ++i) {
+		_on_screen.push_back (index (*i));
+	}
+}
@@ -0,0 +1,100 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  src/playback_cursor.h
+ *  @brief PlaybackCursor class.
+ */
+
+#ifndef LIBSUB_PLAYBACK_CURSOR_H
+#define LIBSUB_PLAYBACK_CURSOR_H
+
+#include "sub_time.h"
+#include "interval_tree.h"
+#include <boost/noncopyable.hpp>
+#include <stdint.h>
+#include <vector>
+
+namespace sub {
+
+class Timeline;
+
+/** @class PlaybackEvent
+ *  @brief A subtitle appearing or disappearing.
+ */
+class PlaybackEvent
+{
+public:
+	enum Type {
+		ENTER,
+		EXIT
+	};
+
+	PlaybackEvent (Type type_, size_t index_)
+		: type (type_)
+		, index (index_)
+	{}
+
+	Type type;
+	/** index of the subtitle in the container that the Timeline was made from */
+	size_t index;
+};
+
+/** @class PlaybackCursor
+ *  @brief Something to follow video playback through a Timeline, saying when
+ *  subtitles appear and disappear.
+ *
+ *  Times are whole video frames: a subtitle is on screen from the frame that its from
+ *  time is in up to, but not including, the frame that its to time is in, where
+ *  frames are counted as Time::frames_at() does.  After set-up a PlaybackCursor does not
+ *  allocate memory unless there are more subtitles on screen at once than it has seen
+ *  before.
+ */
+class PlaybackCursor : public boost::noncopyable
+{
+public:
+	PlaybackCursor (Timeline const & timeline, Rational rate);
+
+	std::vector<PlaybackEvent> const & move (int64_t frame);
+	std::vector<PlaybackEvent> const & move (Time const & t);
+
+	/** @return indices of the subtitles that are on screen, in order of from time */
+	std::vector<size_t> const & on_screen () const {
+		return _on_screen;
+	}
+
+	int64_t frame (Time const & t) const;
+
+private:
+	void update_on_screen ();
+	size_t index (size_t position) const;
+
+	Timeline const & _timeline;
+	int64_t _fps;
+	/** from and to frames of the subtitles, at the same positions as in the timeline's tree */
+	IntervalTree<int64_t> _tree;
+	IntervalTreeCursor<int64_t> _cursor;
+	/** positions of the subtitles which were on screen before the last move, in ascending order */
+	std::vector<size_t> _previous;
+	std::vector<size_t> _on_screen;
+	std::vector<PlaybackEvent> _events;
+};
+
+}
+
+#endif
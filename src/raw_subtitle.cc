@@ -18,7 +18,10 @@
 */
 
 #include "raw_subtitle.h"
+#include <algorithm>
+#include <cstring>
 
+using std::vector;
 using namespace sub;
 
 bool
@@ -26,3 +29,110 @@ sub::operator< (RawSubtitle const & a, RawSubtitle const & b)
 {
 	return a.from < b.from;
 }
+
+bool
+sub::raw_subtitle_pointer_less (RawSubtitle const * a, RawSubtitle const * b)
+{
+	return *a < *b;
+}
+
+/** A RawSubtitle's from time in ticks (shifted so that it sorts as unsigned) and its index */
+struct SortKey
+{
+	uint64_t key;
+	uint32_t index;
+};
+
+/** Smallest number of subtitles for which sort_raw_subtitles() uses a radix sort */
+static size_t const min_radix_sort_size = 256;
+
+/** Sort keys by key using a least-significant-digit radix sort, which is stable.
+ *  @param keys Keys to sort.
+ *  @param scratch Space for the same number of keys.
+ *  @return The sorted keys, which will be either keys or scratch.
+ */
+static SortKey*
+radix_sort (SortKey* keys, SortKey* scratch, size_t n)
+{
+	size_t counts[8][256];
+	memset (counts, 0, sizeof (counts));
+	for (size_t i = 0; i < n; ++i) {
+		uint64_t const k = keys[i].key;
+		for (int j = 0; j < 8; ++j) {
+			++counts[j][(k >> (j * 8)) & 0xff];
+		}
+	}
+
+	for (int j = 0; j < 8; ++j) {
+		size_t* c = counts[j];
+		uint64_t const first = (keys[0].key >> (j * 8)) & 0xff;
+		if (c[first] == n) {
+			/* Every key has the same value of this digit */
+			continue;
+		}
+
+		size_t offset = 0;
+		for (int k = 0; k < 256; ++k) {
+			size_t const t = c[k];
+			c[k] = offset;
+			offset += t;
+		}
+
+		for (size_t i = 0; i < n; ++i) {
+			scratch[c[(keys[i].key >> (j * 8)) & 0xff]++] = keys[i];
+		}
+
+		std::swap (keys, scratch);
+	}
+
+	return keys;
+}
+
+/** Sort some RawSubtitles by from time.  Those with equal from times stay in
+ *  the same order, as they would with std::list::sort.  If all the from times
+ *  are in ticks this is done with a radix sort of a compact array of keys,
+ *  rather than by comparing Times.
+ */
+template <class T>
+static void
+sort_raw_subtitles_impl (vector<T*>& subs)
+{
+	size_t const n = subs.size ();
+
+	bool ticks = n >= min_radix_sort_size && n <= 0xffffffff;
+	for (size_t i = 0; ticks && i < n; ++i) {
+		ticks = subs[i]->from.has_ticks ();
+	}
+
+	if (!ticks) {
+		std::stable_sort (subs.begin(), subs.end(), raw_subtitle_pointer_less);
+		return;
+	}
+
+	vector<SortKey> keys (n);
+	for (size_t i = 0; i < n; ++i) {
+		keys[i].key = static_cast<uint64_t> (subs[i]->from.ticks()) ^ (uint64_t (1) << 63);
+		keys[i].index = i;
+	}
+
+	vector<SortKey> scratch (n);
+	SortKey const * sorted = radix_sort (&keys[0], &scratch[0], n);
+
+	vector<T*> out (n);
+	for (size_t i = 0; i < n; ++i) {
+		out[i] = subs[sorted[i].index];
+	}
+	subs.swap (out);
+}
+
+void
+sub::sort_raw_subtitles (vector<RawSubtitle *>& subs)
+{
+	sort_raw_subtitles_impl (subs);
+}
+
+void
+sub::sort_raw_subtitles (vector<RawSubtitle const *>& subs)
+{
+	sort_raw_subtitles_impl (subs);
+}
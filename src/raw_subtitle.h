@@ -27,9 +27,11 @@
 #include "font_size.h"
 #include "vertical_position.h"
 #include "horizontal_position.h"
+#include "subrip_coordinates.h"
 #include <boost/optional.hpp>
 #include <string>
 #include <list>
+#include <vector>
 
 namespace sub {
 
@@ -66,6 +68,9 @@ public:
 	/** vertical position of the baseline of the text */
 	VerticalPosition vertical_position;
 
+	/** position box from a SubRip file, if there was one */
+	boost::optional<SubripCoordinates> subrip_coordinates;
+
 	/** from time */
 	Time from;
 	/** to time */
@@ -76,6 +81,9 @@ public:
 };
 
 bool operator< (RawSubtitle const &, RawSubtitle const &);
+bool raw_subtitle_pointer_less (RawSubtitle const *, RawSubtitle const *);
+void sort_raw_subtitles (std::vector<RawSubtitle *>& subs);
+void sort_raw_subtitles (std::vector<RawSubtitle const *>& subs);
 
 }
 
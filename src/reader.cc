@@ -18,11 +18,13 @@
 */
 
 #include "reader.h"
+#include <algorithm>
 #include <string>
 #include <iostream>
 
 using std::string;
 using std::cout;
+using boost::optional;
 using namespace sub;
 
 void
@@ -31,3 +33,29 @@ Reader::warn (string m) const
 	/* XXX */
 	cout << m << "\n";
 }
+
+/** Read the next subtitle from the source.
+ *  @return Subtitle, or an empty optional if there are no more.
+ */
+optional<RawSubtitle>
+Reader::next ()
+{
+	while (_subs.empty() && read_more()) {}
+
+	if (_subs.empty ()) {
+		return optional<RawSubtitle> ();
+	}
+
+	/* Swap the subtitle out rather than copying its text and so on */
+	optional<RawSubtitle> s = RawSubtitle ();
+	std::swap (*s, _subs.front ());
+	_subs.pop_front ();
+	return s;
+}
+
+/** Read the rest of the source into _subs */
+void
+Reader::read_all ()
+{
+	while (read_more ()) {}
+}
@@ -21,6 +21,7 @@
 #define LIBSUB_READER_H
 
 #include "raw_subtitle.h"
+#include <boost/optional.hpp>
 #include <list>
 #include <map>
 #include <string>
@@ -29,18 +30,46 @@ struct subrip_reader_convert_line_test;
 
 namespace sub {
 
+/** How a Reader should read its source */
+enum ReadMode {
+	/** read the whole source when the Reader is constructed */
+	READ_ALL,
+	/** read the source only as subtitles are asked for by Reader::next(); the source
+	 *  must then remain valid until next() has returned an empty optional.
+	 */
+	READ_ON_DEMAND
+};
+
 /** @class Reader
  *  @brief Parent for classes which can read particular subtitle formats.
+ *
+ *  Subtitles can be pulled from a Reader one at a time using next(), or
+ *  all at once using subtitles().
  */
 class Reader
 {
 public:
 	virtual ~Reader () {}
 
-	std::list<RawSubtitle> subtitles () const {
+	/** @return Subtitles which have been read and not yet returned by next().
+	 *  If this Reader was constructed with READ_ALL this is everything in the source
+	 *  (less anything which has been taken by next()).
+	 */
+	std::list<RawSubtitle> const & subtitles () const {
 		return _subs;
 	}
 
+	/** Take the subtitles that subtitles() would return out of this Reader,
+	 *  without copying them.  Afterwards subtitles() will be empty.
+	 */
+	std::list<RawSubtitle> take_subtitles () {
+		std::list<RawSubtitle> s;
+		s.swap (_subs);
+		return s;
+	}
+
+	boost::optional<RawSubtitle> next ();
+
 	virtual std::map<std::string, std::string> metadata () const {
 		return std::map<std::string, std::string> ();
 	}
@@ -50,6 +79,15 @@ protected:
 
 	void warn (std::string) const;
 
+	/** Read some more of the source, adding any subtitles that are found to _subs.
+	 *  @return false if the end of the source has been reached, otherwise true.
+	 */
+	virtual bool read_more () {
+		return false;
+	}
+
+	void read_all ();
+
 	std::list<RawSubtitle> _subs;
 };
 
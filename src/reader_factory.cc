@@ -22,7 +22,7 @@
 #include "stl_text_reader.h"
 #include "dcp_reader.h"
 #include "subrip_reader.h"
-#include "sub_assert.h"
+#include "mapped_file.h"
 #include <libxml++/libxml++.h>
 #include <boost/algorithm/string.hpp>
 #include <fstream>
@@ -62,11 +62,11 @@ sub::reader_factory (boost::filesystem::path file_name)
 	}
 
 	if (ext == ".srt") {
-		FILE* f = fopen (file_name.string().c_str(), "r");
-		SUB_ASSERT (f);
-		shared_ptr<Reader> r (new SubripReader(f));
-		fclose (f);
-		return r;
+		/* The reader parses everything in its constructor, so the file
+		   does not need to stay mapped after that.
+		*/
+		MappedFile f (file_name);
+		return shared_ptr<Reader> (new SubripReader (f.data(), f.size(), READ_ALL));
 	}
 
 	return shared_ptr<Reader> ();
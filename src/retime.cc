@@ -0,0 +1,197 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  src/retime.cc
+ *  @brief Retime class and functions to retime whole tracks of subtitles.
+ */
+
+#include "retime.h"
+#include "sub_assert.h"
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <algorithm>
+#include <limits>
+
+using std::vector;
+using std::min;
+using std::numeric_limits;
+using namespace sub;
+
+/** Smallest number of times that retime() will give to a thread */
+static size_t const min_chunk_size = 65536;
+
+static int64_t
+gcd (int64_t a, int64_t b)
+{
+	while (b) {
+		int64_t const t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+/** @return a * b, or 0 with fits set to false if the product would not fit in an int64_t */
+static int64_t
+multiply (int64_t a, int64_t b, bool& fits)
+{
+	if (a == 0 || b == 0) {
+		return 0;
+	}
+
+	int64_t const largest = numeric_limits<int64_t>::max ();
+	if (
+		a == numeric_limits<int64_t>::min() || b == numeric_limits<int64_t>::min() ||
+		(a < 0 ? -a : a) > largest / (b < 0 ? -b : b)
+		) {
+		fits = false;
+		return 0;
+	}
+
+	return a * b;
+}
+
+/** The parts of a Retime that are needed to apply it to tick counts.  A time of t ticks
+ *  becomes floor ((t * multiplier + add) / divisor) frames at the output rate.
+ */
+struct TickRetime
+{
+	int64_t multiplier;
+	int64_t add;
+	int64_t divisor;
+};
+
+/** Retime [begin, end) of a list of times in ticks, writing frames at the output rate
+ *  over the top.  This is a simple loop over contiguous integers so that the compiler
+ *  can do what it likes with it.
+ */
+static void
+retime_ticks (int64_t* begin, int64_t* end, TickRetime r)
+{
+	for (int64_t* i = begin; i != end; ++i) {
+		int64_t const n = *i * r.multiplier + r.add;
+		/* floor division */
+		int64_t q = n / r.divisor;
+		q -= (n % r.divisor != 0) & (n < 0);
+		*i = q;
+	}
+}
+
+static void
+retime_one_by_one (vector<Time>& times, Retime const & r)
+{
+	for (vector<Time>::iterator i = times.begin(); i != times.end(); ++i) {
+		i->retime (r.scale, r.offset, r.rate);
+	}
+}
+
+/** Retime some times in place.  Times which are a whole number of ticks (which is
+ *  most of them) are retimed in bulk using integer arithmetic; the rest are done
+ *  one by one with Time::retime.  The results are the same as if Time::retime had been
+ *  used for every time, including when the bulk arithmetic would overflow, in which
+ *  case every time is done with Time::retime.
+ *  @param threads Number of threads to use if there are a lot of times, or 0 for
+ *  one per CPU core.
+ */
+void
+sub::retime (vector<Time>& times, Retime const & r, int threads)
+{
+	SUB_ASSERT (r.scale.numerator >= 0);
+	SUB_ASSERT (r.scale.denominator > 0);
+	SUB_ASSERT (r.rate.denominator != 0);
+	SUB_ASSERT (r.rate.integer ());
+
+	if (times.empty ()) {
+		return;
+	}
+
+	if (!r.offset.has_ticks ()) {
+		retime_one_by_one (times, r);
+		return;
+	}
+
+	/* Pull out the tick counts into a contiguous array */
+	vector<int64_t> ticks (times.size ());
+	int64_t largest = 0;
+	for (size_t i = 0; i < times.size(); ++i) {
+		ticks[i] = times[i].ticks ();
+		largest = std::max (largest, ticks[i] < 0 ? -ticks[i] : ticks[i]);
+	}
+
+	/* t ticks is t / T seconds (T being ticks_per_second), so after retiming it is
+	   (t * sn / sd + o) / T seconds, or (t * sn + o * sd) * fps / (T * sd) frames,
+	   which we round to the nearest frame by adding half of the divisor before
+	   taking the floor.
+	*/
+	int64_t fps = r.rate.integer_fraction ();
+	int64_t T = Time::ticks_per_second;
+	int64_t const g = gcd (fps, T);
+	fps /= g;
+	T /= g;
+
+	bool fits = true;
+	TickRetime tr;
+	tr.multiplier = multiply (2 * int64_t (r.scale.numerator), fps, fits);
+	tr.divisor = multiply (2 * T, r.scale.denominator, fits);
+	int64_t const shift = multiply (multiply (2 * r.offset.ticks(), r.scale.denominator, fits), fps, fits);
+	int64_t const half = multiply (T, r.scale.denominator, fits);
+	int64_t const bound = numeric_limits<int64_t>::max() - (shift < 0 ? -shift : shift) - half;
+	int64_t const largest_product = multiply (largest, tr.multiplier, fits);
+
+	if (!fits || bound < 0 || largest_product > bound) {
+		/* Some t * multiplier + add could overflow, so do it the slow way */
+		retime_one_by_one (times, r);
+		return;
+	}
+
+	tr.add = shift + half;
+
+	if (threads <= 0) {
+		threads = std::max (1U, boost::thread::hardware_concurrency ());
+	}
+
+	size_t const chunks = min (static_cast<size_t> (threads), std::max (static_cast<size_t> (1), ticks.size() / min_chunk_size));
+	if (chunks == 1) {
+		retime_ticks (&ticks[0], &ticks[0] + ticks.size(), tr);
+	} else {
+		boost::thread_group group;
+		for (size_t i = 0; i < chunks; ++i) {
+			int64_t* begin = &ticks[0] + ticks.size() * i / chunks;
+			int64_t* end = &ticks[0] + ticks.size() * (i + 1) / chunks;
+			group.create_thread (boost::bind (&retime_ticks, begin, end, tr));
+		}
+		group.join_all ();
+	}
+
+	int const frames_per_second = r.rate.integer_fraction ();
+	for (size_t i = 0; i < times.size(); ++i) {
+		if (!times[i].has_ticks ()) {
+			times[i].retime (r.scale, r.offset, r.rate);
+			continue;
+		}
+		/* ticks[i] is now a number of frames */
+		int64_t seconds = ticks[i] / frames_per_second;
+		int64_t frames = ticks[i] % frames_per_second;
+		if (frames < 0) {
+			frames += frames_per_second;
+			--seconds;
+		}
+		times[i] = Time::from_hmsf (0, 0, seconds, frames, r.rate);
+	}
+}
@@ -0,0 +1,93 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  src/retime.h
+ *  @brief Retime class and functions to retime whole tracks of subtitles.
+ */
+
+#ifndef LIBSUB_RETIME_H
+#define LIBSUB_RETIME_H
+
+#include "sub_time.h"
+#include <vector>
+
+namespace sub {
+
+/** @class Retime
+ *  @brief A change to the timing of some subtitles, where each time t becomes
+ *  t * scale + offset, rounded to the nearest frame at rate.
+ *
+ *  For example, to conform subtitles made for 24fps to a PAL speed-up the scale
+ *  would be 24/25 and the rate 25.
+ *
+ *  The output rate must be an integer, as Time cannot hold frames at a rate such as
+ *  24000/1001.  A conversion to 23.976fps can therefore only be rounded to the
+ *  nearest frame at some integer rate (e.g. 24, or 1000 for milliseconds); the
+ *  results are not exact 23.976fps frames.
+ */
+class Retime
+{
+public:
+	/** @param scale_ Amount to scale times by; must be positive.
+	 *  @param offset_ Amount to add to times after scaling; its rate must be specified.
+	 *  @param rate_ Frame rate of the results; must be integer.
+	 */
+	Retime (Rational scale_, Time offset_, Rational rate_)
+		: scale (scale_)
+		, offset (offset_)
+		, rate (rate_)
+	{}
+
+	Rational scale;
+	Time offset;
+	Rational rate;
+};
+
+extern void retime (std::vector<Time>& times, Retime const & retime, int threads = 1);
+
+/** Retime a track of RawSubtitles.
+ *  @param subs Subtitles, in any container of RawSubtitle.
+ *  @param threads Number of threads to use for large tracks, or 0 for one per CPU core.
+ *  @return The retimed subtitles.
+ */
+template <class T>
+T
+retime (T subs, Retime const & r, int threads = 1)
+{
+	std::vector<Time> times;
+	times.reserve (subs.size() * 2);
+	for (typename T::const_iterator i = subs.begin(); i != subs.end(); ++i) {
+		times.push_back (i->from);
+		times.push_back (i->to);
+	}
+
+	retime (times, r, threads);
+
+	std::vector<Time>::const_iterator j = times.begin ();
+	for (typename T::iterator i = subs.begin(); i != subs.end(); ++i) {
+		i->from = *j++;
+		i->to = *j++;
+	}
+
+	return subs;
+}
+
+}
+
+#endif
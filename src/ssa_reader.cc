@@ -23,9 +23,10 @@
 #include "raw_convert.h"
 #include "subtitle.h"
 #include "compose.hpp"
+#include "line_source.h"
 #include <boost/algorithm/string.hpp>
-#include <boost/bind.hpp>
 #include <boost/foreach.hpp>
+#include <cstring>
 #include <iostream>
 #include <vector>
 
@@ -35,20 +36,45 @@ using std::map;
 using std::cout;
 using std::list;
 using boost::optional;
-using boost::function;
 using namespace boost::algorithm;
 using namespace sub;
 
 /** @param s Subtitle string encoded in UTF-8 */
-SSAReader::SSAReader (string s)
+SSAReader::SSAReader (string s, ReadMode mode)
+	: _string (s)
 {
-	this->read (boost::bind(&get_line_string, &s));
+	start (new BufferLineSource (_string.data(), _string.size()), mode);
 }
 
 /** @param f Subtitle file encoded in UTF-8 */
-SSAReader::SSAReader (FILE* f)
+SSAReader::SSAReader (FILE* f, ReadMode mode)
 {
-	this->read (boost::bind (&get_line_file, f));
+	start (new FileLineSource (f), mode);
+}
+
+/** @param data Subtitles encoded in UTF-8, perhaps from a MappedFile; this buffer is
+ *  not copied, so with READ_ON_DEMAND it must outlive the reader.
+ *  @param size Size of data in bytes.
+ */
+SSAReader::SSAReader (char const * data, size_t size, ReadMode mode)
+{
+	start (new BufferLineSource (data, size), mode);
+}
+
+/** @param source Source of lines, which we will take ownership of */
+template <class S>
+void
+SSAReader::start (S* source, ReadMode mode)
+{
+	_source.reset (new ReaderLineSourceImpl<SSAReader, S> (source));
+
+	_part = INFO;
+	_play_res_x = 288;
+	_play_res_y = 288;
+
+	if (mode == READ_ALL) {
+		read_all ();
+	}
 }
 
 Colour
@@ -67,136 +93,150 @@ h_colour (string s)
 	return sub::Colour(ir / 255.0, ig / 255.0, ib / 255.0);
 }
 
-class Style
+SSAReader::Style::Style ()
+	: font_size (72)
+	, primary_colour (255, 255, 255)
+	, bold (false)
+	, italic (false)
+	, underline (false)
+	, horizontal_reference (HORIZONTAL_CENTRE_OF_SCREEN)
+	, vertical_reference (BOTTOM_OF_SCREEN)
+	, vertical_margin (0)
+{}
+
+SSAReader::Style::Style (string format_line, string style_line)
+	: font_size (72)
+	, primary_colour (255, 255, 255)
+	, bold (false)
+	, italic (false)
+	, underline (false)
+	, horizontal_reference (HORIZONTAL_CENTRE_OF_SCREEN)
+	, vertical_reference (BOTTOM_OF_SCREEN)
+	, vertical_margin (0)
 {
-public:
-	Style ()
-		: font_size (72)
-		, primary_colour (255, 255, 255)
-		, bold (false)
-		, italic (false)
-		, underline (false)
-		, horizontal_reference (HORIZONTAL_CENTRE_OF_SCREEN)
-		, vertical_reference (BOTTOM_OF_SCREEN)
-		, vertical_margin (0)
-	{}
-
-	Style (string format_line, string style_line)
-		: font_size (72)
-		, primary_colour (255, 255, 255)
-		, bold (false)
-		, italic (false)
-		, underline (false)
-		, horizontal_reference (HORIZONTAL_CENTRE_OF_SCREEN)
-		, vertical_reference (BOTTOM_OF_SCREEN)
-		, vertical_margin (0)
-	{
-		vector<string> keys;
-		split (keys, format_line, boost::is_any_of (","));
-		vector<string> style;
-		split (style, style_line, boost::is_any_of (","));
-
-		SUB_ASSERT (!keys.empty());
-		SUB_ASSERT (!style.empty());
-		SUB_ASSERT (keys.size() == style.size());
-
-		for (size_t i = 0; i < style.size(); ++i) {
-			trim (keys[i]);
-			trim (style[i]);
-			if (keys[i] == "Name") {
-				name = style[i];
-			} else if (keys[i] == "Fontname") {
-				font_name = style[i];
-			} else if (keys[i] == "Fontsize") {
-				font_size = raw_convert<int> (style[i]);
-			} else if (keys[i] == "PrimaryColour") {
-				primary_colour = colour (style[i]);
-			} else if (keys[i] == "BackColour") {
-				back_colour = colour (style[i]);
-			} else if (keys[i] == "Bold") {
-				bold = style[i] == "-1";
-			} else if (keys[i] == "Italic") {
-				italic = style[i] == "-1";
-			} else if (keys[i] == "Underline") {
-				underline = style[i] == "-1";
-			} else if (keys[i] == "BorderStyle") {
-				if (style[i] == "1") {
-					effect = SHADOW;
-				}
-			} else if (keys[i] == "Alignment") {
-				/* These values from libass' source code */
-				switch ((raw_convert<int> (style[i]) - 1) % 3) {
-				case 0:
-					horizontal_reference = LEFT_OF_SCREEN;
-					break;
-				case 1:
-					horizontal_reference = HORIZONTAL_CENTRE_OF_SCREEN;
-					break;
-				case 2:
-					horizontal_reference = RIGHT_OF_SCREEN;
-					break;
-				}
-				switch (raw_convert<int> (style[i]) & 12) {
-				case 4:
-					vertical_reference = TOP_OF_SCREEN;
-					break;
-				case 8:
-					vertical_reference = VERTICAL_CENTRE_OF_SCREEN;
-					break;
-				case 0:
-					vertical_reference = BOTTOM_OF_SCREEN;
-					break;
-				}
-			} else if (keys[i] == "MarginV") {
-				vertical_margin = raw_convert<int> (style[i]);
+	vector<string> keys;
+	split (keys, format_line, boost::is_any_of (","));
+	vector<string> style;
+	split (style, style_line, boost::is_any_of (","));
+
+	SUB_ASSERT (!keys.empty());
+	SUB_ASSERT (!style.empty());
+	SUB_ASSERT (keys.size() == style.size());
+
+	for (size_t i = 0; i < style.size(); ++i) {
+		trim (keys[i]);
+		trim (style[i]);
+		if (keys[i] == "Name") {
+			name = style[i];
+		} else if (keys[i] == "Fontname") {
+			font_name = style[i];
+		} else if (keys[i] == "Fontsize") {
+			font_size = raw_convert<int> (style[i]);
+		} else if (keys[i] == "PrimaryColour") {
+			primary_colour = colour (style[i]);
+		} else if (keys[i] == "BackColour") {
+			back_colour = colour (style[i]);
+		} else if (keys[i] == "Bold") {
+			bold = style[i] == "-1";
+		} else if (keys[i] == "Italic") {
+			italic = style[i] == "-1";
+		} else if (keys[i] == "Underline") {
+			underline = style[i] == "-1";
+		} else if (keys[i] == "BorderStyle") {
+			if (style[i] == "1") {
+				effect = SHADOW;
+			}
+		} else if (keys[i] == "Alignment") {
+			/* These values from libass' source code */
+			switch ((raw_convert<int> (style[i]) - 1) % 3) {
+			case 0:
+				horizontal_reference = LEFT_OF_SCREEN;
+				break;
+			case 1:
+				horizontal_reference = HORIZONTAL_CENTRE_OF_SCREEN;
+				break;
+			case 2:
+				horizontal_reference = RIGHT_OF_SCREEN;
+				break;
+			}
+			switch (raw_convert<int> (style[i]) & 12) {
+			case 4:
+				vertical_reference = TOP_OF_SCREEN;
+				break;
+			case 8:
+				vertical_reference = VERTICAL_CENTRE_OF_SCREEN;
+				break;
+			case 0:
+				vertical_reference = BOTTOM_OF_SCREEN;
+				break;
 			}
+		} else if (keys[i] == "MarginV") {
+			vertical_margin = raw_convert<int> (style[i]);
 		}
 	}
+}
 
-	string name;
-	optional<string> font_name;
-	int font_size;
-	Colour primary_colour;
-	/** outline colour */
-	optional<Colour> back_colour;
-	bool bold;
-	bool italic;
-	bool underline;
-	optional<Effect> effect;
-	HorizontalReference horizontal_reference;
-	VerticalReference vertical_reference;
-	int vertical_margin;
-
-private:
-	Colour colour (string c) const
-	{
-		if (c.length() > 0 && c[0] == '&') {
-			/* &Hbbggrr or &Haabbggrr */
-			return h_colour (c);
-		} else {
-			/* integer */
-			int i = raw_convert<int>(c);
-			return Colour (
-				((i & 0x0000ff) >>  0) / 255.0,
-				((i & 0x00ff00) >>  8) / 255.0,
-				((i & 0xff0000) >> 16) / 255.0
-				);
-		}
+Colour
+SSAReader::Style::colour (string c) const
+{
+	if (c.length() > 0 && c[0] == '&') {
+		/* &Hbbggrr or &Haabbggrr */
+		return h_colour (c);
+	} else {
+		/* integer */
+		int i = raw_convert<int>(c);
+		return Colour (
+			((i & 0x0000ff) >>  0) / 255.0,
+			((i & 0x00ff00) >>  8) / 255.0,
+			((i & 0xff0000) >> 16) / 255.0
+			);
+	}
+}
+
+/** Parse an integer as raw_convert<int> would: an optional sign then digits,
+ *  stopping at anything else.
+ */
+static int
+parse_int (char const *& p, char const * end)
+{
+	bool negative = false;
+	if (p != end && (*p == '-' || *p == '+')) {
+		negative = *p == '-';
+		++p;
+	}
+
+	int n = 0;
+	while (p != end && *p >= '0' && *p <= '9') {
+		n = n * 10 + *p - '0';
+		++p;
 	}
-};
 
+	return negative ? -n : n;
+}
+
+/** @param t Time in the form h:mm:ss.cc */
 Time
-SSAReader::parse_time (string t) const
+SSAReader::parse_time (LineView t) const
 {
-	vector<string> bits;
-	split (bits, t, is_any_of (":."));
-	SUB_ASSERT (bits.size() == 4);
-	return Time::from_hms (
-		raw_convert<int> (bits[0]),
-		raw_convert<int> (bits[1]),
-		raw_convert<int> (bits[2]),
-		raw_convert<int> (bits[3]) * 10
-		);
+	int bits[4];
+	int n = 0;
+	char const * p = t.data ();
+	char const * end = p + t.size ();
+	while (true) {
+		SUB_ASSERT (n < 4);
+		bits[n++] = parse_int (p, end);
+		/* Skip anything up to the next separator */
+		while (p != end && *p != ':' && *p != '.') {
+			++p;
+		}
+		if (p == end) {
+			break;
+		}
+		++p;
+	}
+
+	SUB_ASSERT (n == 4);
+	return Time::from_hms (bits[0], bits[1], bits[2], bits[3] * 10);
 }
 
 /** @param base RawSubtitle filled in with any required common values.
@@ -205,6 +245,15 @@ SSAReader::parse_time (string t) const
  */
 list<RawSubtitle>
 SSAReader::parse_line (RawSubtitle base, string line, int play_res_x, int play_res_y)
+{
+	list<RawSubtitle> subs;
+	parse_line (subs, base, LineView (line.data(), line.size()), play_res_x, play_res_y);
+	return subs;
+}
+
+/** Parse a line as the public parse_line() does, adding the resulting RawSubtitles to subs */
+void
+SSAReader::parse_line (list<RawSubtitle>& subs, RawSubtitle const & base, LineView line, int play_res_x, int play_res_y)
 {
 	enum {
 		TEXT,
@@ -212,7 +261,6 @@ SSAReader::parse_line (RawSubtitle base, string line, int play_res_x, int play_r
 		BACKSLASH
 	} state = TEXT;
 
-	list<RawSubtitle> subs;
 	RawSubtitle current = base;
 	string style;
 
@@ -234,8 +282,8 @@ SSAReader::parse_line (RawSubtitle base, string line, int play_res_x, int play_r
 
 	/* Count the number of line breaks */
 	int line_breaks = 0;
-	if (line.length() > 0) {
-		for (size_t i = 0; i < line.length() - 1; ++i) {
+	if (line.size() > 0) {
+		for (size_t i = 0; i < line.size() - 1; ++i) {
 			if (line[i] == '\\' && (line[i+1] == 'n' || line[i+1] == 'N')) {
 				++line_breaks;
 			}
@@ -259,7 +307,7 @@ SSAReader::parse_line (RawSubtitle base, string line, int play_res_x, int play_r
 		break;
 	}
 
-	for (size_t i = 0; i < line.length(); ++i) {
+	for (size_t i = 0; i < line.size(); ++i) {
 		char const c = line[i];
 		switch (state) {
 		case TEXT:
@@ -343,132 +391,128 @@ SSAReader::parse_line (RawSubtitle base, string line, int play_res_x, int play_r
 	if (!current.text.empty ()) {
 		subs.push_back (current);
 	}
+}
 
-	return subs;
+bool
+SSAReader::read_more ()
+{
+	return _source->read_more (this);
 }
 
-void
-SSAReader::read (function<optional<string> ()> get_line)
+/** Interpret one line of the source.
+ *  @return true if a subtitle may have been added to _subs.
+ */
+bool
+SSAReader::process_line (LineView line)
 {
-	enum {
-		INFO,
-		STYLES,
-		EVENTS
-	} part = INFO;
+	line.trim ();
+	remove_unicode_bom (line);
 
-	int play_res_x = 288;
-	int play_res_y = 288;
-	map<string, Style> styles;
-	string style_format_line;
-	vector<string> event_format;
+	if (line.starts_with (";") || line.empty ()) {
+		return false;
+	}
 
-	while (true) {
-		optional<string> line = get_line ();
-		if (!line) {
-			break;
+	if (line.starts_with ("[")) {
+		/* Section heading */
+		if (line == "[Script Info]") {
+			_part = INFO;
+		} else if (line == "[V4 Styles]" || line == "[V4+ Styles]") {
+			_part = STYLES;
+		} else if (line == "[Events]") {
+			_part = EVENTS;
 		}
+		return false;
+	}
 
-		trim (*line);
-		remove_unicode_bom (line);
-
-		if (starts_with (*line, ";") || line->empty ()) {
-			continue;
+	char const * colon = static_cast<char const *> (memchr (line.data(), ':', line.size()));
+	SUB_ASSERT (colon);
+	string const type (line.data(), colon - line.data());
+	LineView body_view (colon + 1, line.data() + line.size() - colon - 1);
+	body_view.trim ();
+	string const body = body_view.to_string ();
+
+	switch (_part) {
+	case INFO:
+		if (type == "PlayResX") {
+			_play_res_x = raw_convert<int> (body);
+		} else if (type == "PlayResY") {
+			_play_res_y = raw_convert<int> (body);
 		}
-
-		if (starts_with (*line, "[")) {
-			/* Section heading */
-			if (line.get() == "[Script Info]") {
-				part = INFO;
-			} else if (line.get() == "[V4 Styles]" || line.get() == "[V4+ Styles]") {
-				part = STYLES;
-			} else if (line.get() == "[Events]") {
-				part = EVENTS;
-			}
-			continue;
+		break;
+	case STYLES:
+		if (type == "Format") {
+			_style_format_line = body;
+		} else if (type == "Style") {
+			SUB_ASSERT (!_style_format_line.empty ());
+			Style s (_style_format_line, body);
+			_styles[s.name] = s;
 		}
-
-		size_t const colon = line->find (":");
-		SUB_ASSERT (colon != string::npos);
-		string const type = line->substr (0, colon);
-		string body = line->substr (colon + 1);
-		trim (body);
-
-		switch (part) {
-		case INFO:
-			if (type == "PlayResX") {
-				play_res_x = raw_convert<int> (body);
-			} else if (type == "PlayResY") {
-				play_res_y = raw_convert<int> (body);
-			}
-			break;
-		case STYLES:
-			if (type == "Format") {
-				style_format_line = body;
-			} else if (type == "Style") {
-				SUB_ASSERT (!style_format_line.empty ());
-				Style s (style_format_line, body);
-				styles[s.name] = s;
+		break;
+	case EVENTS:
+		if (type == "Format") {
+			split (_event_format, body, is_any_of (","));
+			BOOST_FOREACH (string& i, _event_format) {
+				trim (i);
 			}
-			break;
-		case EVENTS:
-			if (type == "Format") {
-				split (event_format, body, is_any_of (","));
-				BOOST_FOREACH (string& i, event_format) {
-					trim (i);
-				}
-			} else if (type == "Dialogue") {
-				SUB_ASSERT (!event_format.empty ());
-				vector<string> event;
-				split (event, body, is_any_of (","));
-
-				/* There may be commas in the subtitle part; reassemble any extra parts
-				   from when we just split it.
-				*/
-				while (event.size() > event_format.size()) {
-					string const ex = event.back ();
-					event.pop_back ();
-					event.back() += "," + ex;
+		} else if (type == "Dialogue") {
+			SUB_ASSERT (!_event_format.empty ());
+
+			/* There may be commas in the last (subtitle) part, so split at only as many
+			   as there are fields before it.
+			*/
+			_event.clear ();
+			LineView rest = body_view;
+			while (_event.size() + 1 < _event_format.size()) {
+				char const * comma = static_cast<char const *> (memchr (rest.data(), ',', rest.size()));
+				if (!comma) {
+					break;
 				}
-
-				SUB_ASSERT (!event.empty());
-				SUB_ASSERT (event_format.size() == event.size());
-
-				RawSubtitle sub;
-
-				for (size_t i = 0; i < event.size(); ++i) {
-					trim (event[i]);
-					if (event_format[i] == "Start") {
-						sub.from = parse_time (event[i]);
-					} else if (event_format[i] == "End") {
-						sub.to = parse_time (event[i]);
-					} else if (event_format[i] == "Style") {
-						/* libass trims leading '*'s from style names, commenting that
-						   "they seem to mean literally nothing".  Go figure...
-						*/
-						trim_left_if (event[i], boost::is_any_of ("*"));
-						SUB_ASSERT (styles.find(event[i]) != styles.end());
-						Style style = styles[event[i]];
-						sub.font = style.font_name;
-						sub.font_size = FontSize::from_points (style.font_size);
-						sub.colour = style.primary_colour;
-						sub.effect_colour = style.back_colour;
-						sub.bold = style.bold;
-						sub.italic = style.italic;
-						sub.underline = style.underline;
-						sub.effect = style.effect;
-						sub.horizontal_position.reference = style.horizontal_reference;
-						sub.vertical_position.reference = style.vertical_reference;
-						sub.vertical_position.proportional = float(style.vertical_margin) / play_res_y;
-					} else if (event_format[i] == "MarginV") {
-						sub.vertical_position.proportional = raw_convert<float>(event[i]) / play_res_y;
-					} else if (event_format[i] == "Text") {
-						BOOST_FOREACH (sub::RawSubtitle j, parse_line (sub, event[i], play_res_x, play_res_y)) {
-							_subs.push_back (j);
-						}
+				_event.push_back (LineView (rest.data(), comma - rest.data()));
+				rest.remove_prefix (comma - rest.data() + 1);
+			}
+			_event.push_back (rest);
+
+			SUB_ASSERT (_event_format.size() == _event.size());
+
+			RawSubtitle sub;
+
+			for (size_t i = 0; i < _event.size(); ++i) {
+				LineView field = _event[i];
+				field.trim ();
+				if (_event_format[i] == "Start") {
+					sub.from = parse_time (field);
+				} else if (_event_format[i] == "End") {
+					sub.to = parse_time (field);
+				} else if (_event_format[i] == "Style") {
+					/* libass trims leading '*'s from style names, commenting that
+					   "they seem to mean literally nothing".  Go figure...
+					*/
+					while (field.starts_with ("*")) {
+						field.remove_prefix (1);
 					}
+					map<string, Style>::const_iterator j = _styles.find (field.to_string ());
+					SUB_ASSERT (j != _styles.end());
+					Style const & style = j->second;
+					sub.font = style.font_name;
+					sub.font_size = FontSize::from_points (style.font_size);
+					sub.colour = style.primary_colour;
+					sub.effect_colour = style.back_colour;
+					sub.bold = style.bold;
+					sub.italic = style.italic;
+					sub.underline = style.underline;
+					sub.effect = style.effect;
+					sub.horizontal_position.reference = style.horizontal_reference;
+					sub.vertical_position.reference = style.vertical_reference;
+					sub.vertical_position.proportional = float(style.vertical_margin) / _play_res_y;
+				} else if (_event_format[i] == "MarginV") {
+					sub.vertical_position.proportional = raw_convert<float>(field.to_string()) / _play_res_y;
+				} else if (_event_format[i] == "Text") {
+					parse_line (_subs, sub, field, _play_res_x, _play_res_y);
 				}
 			}
+			return true;
 		}
-
 	}
+
+	return false;
 }
@@ -25,7 +25,13 @@
 #define LIBSUB_SSA_READER_H
 
 #include "reader.h"
-#include <boost/function.hpp>
+#include "colour.h"
+#include "effect.h"
+#include "horizontal_reference.h"
+#include "vertical_reference.h"
+#include "line_source.h"
+#include <boost/scoped_ptr.hpp>
+#include <vector>
 
 namespace sub {
 
@@ -38,14 +44,64 @@ namespace sub {
 class SSAReader : public Reader
 {
 public:
-	SSAReader (FILE* f);
-	SSAReader (std::string subs);
+	SSAReader (FILE* f, ReadMode mode = READ_ALL);
+	SSAReader (std::string subs, ReadMode mode = READ_ALL);
+	SSAReader (char const * data, size_t size, ReadMode mode = READ_ALL);
 
 	static std::list<RawSubtitle> parse_line (RawSubtitle base, std::string line, int play_res_x, int play_res_y);
 
 private:
-	void read (boost::function<boost::optional<std::string> ()> get_line);
-	Time parse_time (std::string t) const;
+	class Style
+	{
+	public:
+		Style ();
+		Style (std::string format_line, std::string style_line);
+
+		std::string name;
+		boost::optional<std::string> font_name;
+		int font_size;
+		Colour primary_colour;
+		/** outline colour */
+		boost::optional<Colour> back_colour;
+		bool bold;
+		bool italic;
+		bool underline;
+		boost::optional<Effect> effect;
+		HorizontalReference horizontal_reference;
+		VerticalReference vertical_reference;
+		int vertical_margin;
+
+	private:
+		Colour colour (std::string c) const;
+	};
+
+	template <class, class>
+	friend class ReaderLineSourceImpl;
+
+	template <class S>
+	void start (S* source, ReadMode mode);
+	bool read_more ();
+	bool process_line (LineView line);
+	Time parse_time (LineView t) const;
+	static void parse_line (std::list<RawSubtitle>& subs, RawSubtitle const & base, LineView line, int play_res_x, int play_res_y);
+
+	enum {
+		INFO,
+		STYLES,
+		EVENTS
+	} _part;
+
+	/** Our copy of the subtitles if we were given them as a string */
+	std::string _string;
+	/** Where our lines come from */
+	boost::scoped_ptr<ReaderLineSource<SSAReader> > _source;
+	int _play_res_x;
+	int _play_res_y;
+	std::map<std::string, Style> _styles;
+	std::string _style_format_line;
+	std::vector<std::string> _event_format;
+	/** fields of the Dialogue line being parsed, kept here so that its storage can be re-used */
+	std::vector<LineView> _event;
 };
 
 }
@@ -0,0 +1,139 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  src/stl_binary_gsi.cc
+ *  @brief STLBinaryGSI class.
+ */
+
+#include "stl_binary_gsi.h"
+#include "stl_util.h"
+#include "exceptions.h"
+#include "compose.hpp"
+#include <boost/lexical_cast.hpp>
+#include <cstdio>
+#include <cstdlib>
+
+using std::map;
+using std::string;
+using boost::lexical_cast;
+using namespace sub;
+
+static string
+get_string (unsigned char const * data, int offset, int length)
+{
+	return string (reinterpret_cast<char const *> (data) + offset, length);
+}
+
+/** @param data The 1024-byte GSI block */
+STLBinaryGSI::STLBinaryGSI (unsigned char const * data)
+{
+	read (data);
+}
+
+/** Read the GSI block from the start of a binary STL file */
+STLBinaryGSI::STLBinaryGSI (boost::filesystem::path file)
+{
+	FILE* f = fopen (file.string().c_str(), "rb");
+	if (!f) {
+		throw FileError (String::compose ("Could not open %1", file.string()));
+	}
+
+	unsigned char data[1024];
+	size_t const n = fread (data, 1, sizeof (data), f);
+	fclose (f);
+	if (n != sizeof (data)) {
+		throw STLError ("Could not read GSI block from binary STL file");
+	}
+
+	read (data);
+}
+
+/** Interpret a 1024-byte GSI block */
+void
+STLBinaryGSI::read (unsigned char const * data)
+{
+	code_page_number = atoi (get_string (data, 0, 3).c_str ());
+	frame_rate = stl_dfc_to_frame_rate (get_string (data, 3, 8));
+	display_standard = STLBinaryTables::display_standard_file_to_enum (get_string (data, 11, 1));
+	language_group = STLBinaryTables::language_group_file_to_enum (get_string (data, 12, 2));
+	language = STLBinaryTables::language_file_to_enum (get_string (data, 14, 2));
+	original_programme_title = get_string (data, 16, 32);
+	original_episode_title = get_string (data, 48, 32);
+	translated_programme_title = get_string (data, 80, 32);
+	translated_episode_title = get_string (data, 112, 32);
+	translator_name = get_string (data, 144, 32);
+	translator_contact_details = get_string (data, 176, 32);
+	subtitle_list_reference_code = get_string (data, 208, 16);
+	creation_date = get_string (data, 224, 6);
+	revision_date = get_string (data, 230, 6);
+	revision_number = get_string (data, 236, 2);
+
+	tti_blocks = atoi (get_string (data, 238, 5).c_str ());
+	number_of_subtitles = atoi (get_string (data, 243, 5).c_str ());
+	subtitle_groups = atoi (get_string (data, 248, 3).c_str ());
+	maximum_characters = atoi (get_string (data, 251, 2).c_str ());
+	maximum_rows = atoi (get_string (data, 253, 2).c_str ());
+	timecode_status = STLBinaryTables::timecode_status_file_to_enum (get_string (data, 255, 1));
+	start_of_programme = get_string (data, 256, 8);
+	first_in_cue = get_string (data, 264, 8);
+	disks = atoi (get_string (data, 272, 1).c_str ());
+	disk_sequence_number = atoi (get_string (data, 273, 1).c_str ());
+	country_of_origin = get_string (data, 274, 3);
+	publisher = get_string (data, 277, 32);
+	editor_name = get_string (data, 309, 32);
+	editor_contact_details = get_string (data, 341, 32);
+}
+
+map<string, string>
+STLBinaryGSI::metadata () const
+{
+	map<string, string> m;
+
+	m["Code page number"] = lexical_cast<string> (code_page_number);
+	m["Frame rate"] = lexical_cast<string> (frame_rate);
+	m["Display standard"] = STLBinaryTables::display_standard_enum_to_description (display_standard);
+	m["Language group"] = STLBinaryTables::language_group_enum_to_description (language_group);
+	m["Language"] = STLBinaryTables::language_enum_to_description (language);
+	m["Original programme title"] = original_programme_title;
+	m["Original episode title"] = original_episode_title;
+	m["Translated programme title"] = translated_programme_title;
+	m["Translated episode title"] = translated_episode_title;
+	m["Translator name"] = translator_name;
+	m["Translator contact details"] = translator_contact_details;
+	m["Subtitle list reference code"] = subtitle_list_reference_code;
+	m["Creation date"] = creation_date;
+	m["Revision date"] = revision_date;
+	m["Revision number"] = revision_number;
+	m["TTI blocks"] = lexical_cast<string> (tti_blocks);
+	m["Number of subtitles"] = lexical_cast<string> (number_of_subtitles);
+	m["Subtitle groups"] = lexical_cast<string> (subtitle_groups);
+	m["Maximum characters"] = lexical_cast<string> (maximum_characters);
+	m["Maximum rows"] = lexical_cast<string> (maximum_rows);
+	m["Timecode status"] = STLBinaryTables::timecode_status_enum_to_description (timecode_status);
+	m["Start of programme"] = start_of_programme;
+	m["First in cue"] = first_in_cue;
+	m["Disks"] = lexical_cast<string> (disks);
+	m["Disk sequence number"] = lexical_cast<string> (disk_sequence_number);
+	m["Country of origin"] = country_of_origin;
+	m["Publisher"] = publisher;
+	m["Editor name"] = editor_name;
+	m["Editor contact details"] = editor_contact_details;
+
+	return m;
+}
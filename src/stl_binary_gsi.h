@@ -0,0 +1,86 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  src/stl_binary_gsi.h
+ *  @brief STLBinaryGSI class.
+ */
+
+#ifndef LIBSUB_STL_BINARY_GSI_H
+#define LIBSUB_STL_BINARY_GSI_H
+
+#include "stl_binary_tables.h"
+#include <boost/filesystem.hpp>
+#include <map>
+#include <string>
+
+namespace sub {
+
+/** @class STLBinaryGSI
+ *  @brief The information in the GSI block at the start of a binary STL file.
+ *
+ *  Making one of these from a file reads only the file's first 1024 bytes, so it
+ *  is a quick way to find out about a file without reading its subtitles.
+ */
+class STLBinaryGSI
+{
+public:
+	explicit STLBinaryGSI (unsigned char const * data);
+	explicit STLBinaryGSI (boost::filesystem::path file);
+
+	std::map<std::string, std::string> metadata () const;
+
+	int code_page_number;
+	int frame_rate;
+	DisplayStandard display_standard;
+	LanguageGroup language_group;
+	Language language;
+	std::string original_programme_title;
+	std::string original_episode_title;
+	std::string translated_programme_title;
+	std::string translated_episode_title;
+	std::string translator_name;
+	std::string translator_contact_details;
+	std::string subtitle_list_reference_code;
+	std::string creation_date;
+	std::string revision_date;
+	std::string revision_number;
+	int tti_blocks;
+	int number_of_subtitles;
+	int subtitle_groups;
+	int maximum_characters;
+	int maximum_rows;
+	TimecodeStatus timecode_status;
+	std::string start_of_programme;
+	std::string first_in_cue;
+	int disks;
+	int disk_sequence_number;
+	std::string country_of_origin;
+	std::string publisher;
+	std::string editor_name;
+	std::string editor_contact_details;
+
+protected:
+	STLBinaryGSI () {}
+
+	void read (unsigned char const * data);
+};
+
+}
+
+#endif
@@ -0,0 +1,104 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  src/stl_binary_mapped_reader.cc
+ *  @brief STLBinaryMappedReader class.
+ */
+
+#include "stl_binary_mapped_reader.h"
+#include "exceptions.h"
+#include "sub_assert.h"
+#include <stdint.h>
+#include <algorithm>
+#include <string>
+
+using std::list;
+using std::string;
+using namespace sub;
+
+/** @return the GSI block of a file, checking that there is one */
+static unsigned char const *
+gsi_block (MappedFile const & file)
+{
+	if (file.size() < 1024) {
+		throw STLError ("Could not read GSI block from binary STL file");
+	}
+
+	return reinterpret_cast<unsigned char const *> (file.data ());
+}
+
+STLBinaryMappedReader::STLBinaryMappedReader (boost::filesystem::path file)
+	: _file (file, MappedFile::RANDOM)
+	, _gsi (gsi_block (_file))
+{
+	/* Believe the GSI block's count of TTI blocks unless the file is too short for it */
+	_tti_blocks = std::min (size_t (std::max (_gsi.tti_blocks, 0)), (_file.size() - 1024) / 128);
+}
+
+/** Find the first TTI block whose time code in is at or after some time,
+ *  assuming that the blocks are in order of time code in.
+ *  @return block index, or tti_blocks() if there is no such block.
+ */
+size_t
+STLBinaryMappedReader::find (Time const & t) const
+{
+	int64_t const target = ((int64_t (t.hours()) * 60 + t.minutes()) * 60 + t.seconds()) * _gsi.frame_rate + t.frames_at (Rational (_gsi.frame_rate, 1));
+
+	size_t begin = 0;
+	size_t end = _tti_blocks;
+	while (begin < end) {
+		size_t const mid = begin + (end - begin) / 2;
+		if (tti(mid).time_code_in_frames(_gsi.frame_rate) < target) {
+			begin = mid + 1;
+		} else {
+			end = mid;
+		}
+	}
+
+	return begin;
+}
+
+/** Decode the subtitle which starts at some TTI block, adding it to a list.
+ *  Nothing is added if the block is a comment.
+ *  @param n TTI block index, which should not be an extension block.
+ *  @param subs List to add to.
+ *  @return index of the block after the last one used by the subtitle.
+ */
+size_t
+STLBinaryMappedReader::subtitles (size_t n, list<RawSubtitle>& subs) const
+{
+	SUB_ASSERT (n < _tti_blocks);
+
+	STLBinaryTTI const first = tti (n);
+	string text = first.text ();
+	++n;
+
+	while (tti(n - 1).continued() && n < _tti_blocks) {
+		/* Unused space at the end of a block is not the end of the subtitle's text */
+		text.erase (text.find_last_not_of ('\x8f') + 1);
+		text += tti(n).text ();
+		++n;
+	}
+
+	if (STLBinaryTables::comment_file_to_enum (first.comment_flag ()) != COMMENT_YES) {
+		first.subtitles (text, _gsi.frame_rate, _gsi.maximum_rows, subs);
+	}
+
+	return n;
+}
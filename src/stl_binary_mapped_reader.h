@@ -0,0 +1,74 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  src/stl_binary_mapped_reader.h
+ *  @brief STLBinaryMappedReader class.
+ */
+
+#ifndef LIBSUB_STL_BINARY_MAPPED_READER_H
+#define LIBSUB_STL_BINARY_MAPPED_READER_H
+
+#include "mapped_file.h"
+#include "stl_binary_gsi.h"
+#include "stl_binary_tables.h"
+#include "stl_binary_tti.h"
+#include <boost/filesystem.hpp>
+#include <boost/noncopyable.hpp>
+#include <list>
+
+namespace sub {
+
+/** @class STLBinaryMappedReader
+ *  @brief A class to read binary STL files in any order, by mapping them into memory.
+ *
+ *  Opening a file reads only its GSI block, and any TTI block can then be found
+ *  without reading those before it.  Text is only decoded when subtitles() is called.
+ */
+class STLBinaryMappedReader : public boost::noncopyable
+{
+public:
+	explicit STLBinaryMappedReader (boost::filesystem::path file);
+
+	/** @return the information from the file's GSI block */
+	STLBinaryGSI const & gsi () const {
+		return _gsi;
+	}
+
+	/** @return number of TTI blocks in the file, including extension blocks and comments */
+	size_t tti_blocks () const {
+		return _tti_blocks;
+	}
+
+	/** @param n TTI block index, counting from 0 */
+	STLBinaryTTI tti (size_t n) const {
+		return STLBinaryTTI (reinterpret_cast<unsigned char const *> (_file.data()) + 1024 + n * 128);
+	}
+
+	size_t find (Time const & t) const;
+	size_t subtitles (size_t n, std::list<RawSubtitle>& subs) const;
+
+private:
+	MappedFile _file;
+	STLBinaryGSI _gsi;
+	size_t _tti_blocks;
+};
+
+}
+
+#endif
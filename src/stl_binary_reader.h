@@ -21,6 +21,7 @@
 #define LIBSUB_STL_BINARY_READER_H
 
 #include "reader.h"
+#include "stl_binary_gsi.h"
 #include "stl_binary_tables.h"
 #include <map>
 
@@ -28,52 +29,28 @@ namespace sub {
 
 /** @class STLBinaryReader
  *  @brief A class to read binary STL files.
+ *
+ *  The information from the file's GSI block is in the public members inherited
+ *  from STLBinaryGSI.
  */
-class STLBinaryReader : public Reader
+class STLBinaryReader : public Reader, public STLBinaryGSI
 {
 public:
-	STLBinaryReader (std::istream &);
+	STLBinaryReader (std::istream &, ReadMode mode = READ_ALL);
 	~STLBinaryReader ();
 
-	std::map<std::string, std::string> metadata () const;
-
-	int code_page_number;
-	int frame_rate;
-	DisplayStandard display_standard;
-	LanguageGroup language_group;
-	Language language;
-	std::string original_programme_title;
-	std::string original_episode_title;
-	std::string translated_programme_title;
-	std::string translated_episode_title;
-	std::string translator_name;
-	std::string translator_contact_details;
-	std::string subtitle_list_reference_code;
-	std::string creation_date;
-	std::string revision_date;
-	std::string revision_number;
-	int tti_blocks;
-	int number_of_subtitles;
-	int subtitle_groups;
-	int maximum_characters;
-	int maximum_rows;
-	TimecodeStatus timecode_status;
-	std::string start_of_programme;
-	std::string first_in_cue;
-	int disks;
-	int disk_sequence_number;
-	std::string country_of_origin;
-	std::string publisher;
-	std::string editor_name;
-	std::string editor_contact_details;
+	std::map<std::string, std::string> metadata () const {
+		return STLBinaryGSI::metadata ();
+	}
 
 private:
-	std::string get_string (int, int) const;
-	int get_int (int, int) const;
-	Time get_timecode (int) const;
+	bool read_more ();
+	void read_tti_block ();
 
-	STLBinaryTables _tables;
 	unsigned char* _buffer;
+	std::istream& _in;
+	/** number of TTI blocks that we have read so far */
+	int _tti_blocks_read;
 };
 
 }
@@ -22,313 +22,404 @@
 #include "sub_assert.h"
 #include "compose.hpp"
 
-using std::map;
 using std::string;
 using namespace sub;
 
-template <class E, class F>
-void
-code (map<F, STLBinaryCode<E> >& m, F k, E v, string d)
+/** @struct STLBinaryStringCode
+ *  @brief A code for some STL parameter as it appears in the file and a human-readable
+ *  description of what it means.
+ */
+struct STLBinaryStringCode
 {
-	m[k] = STLBinaryCode<E> (v, d);
+	char const * file;
+	char const * description;
+};
+
+/* These tables are indexed by the values of their enums, so their entries must stay
+   in the same order.  Parameters which are written as integers use the enum value
+   as the code in the file.
+*/
+
+/** File code and description of each DisplayStandard */
+static STLBinaryStringCode const display_standard_codes[] = {
+	{ " ", "Undefined" },
+	{ "0", "Open subtitling" },
+	{ "1", "Level 1 teletext" },
+	{ "2", "Level 2 teletext" },
+};
+
+/** File code and description of each LanguageGroup */
+static STLBinaryStringCode const language_group_codes[] = {
+	{ "00", "Latin" },
+	{ "01", "Latin/Cyrillic" },
+	{ "02", "Latin/Arabic" },
+	{ "03", "Latin/Greek" },
+	{ "04", "Latin/Hebrew" },
+};
+
+/** File code and description of each Language, in the order of the enum */
+static STLBinaryStringCode const language_codes[] = {
+	{ "00", "Unknown" },
+	{ "01", "Albanian" },
+	{ "02", "Breton" },
+	{ "03", "Catalan" },
+	{ "04", "Croatian" },
+	{ "05", "Welsh" },
+	{ "06", "Czech" },
+	{ "07", "Danish" },
+	{ "08", "German" },
+	{ "09", "English" },
+	{ "0A", "Spanish" },
+	{ "0B", "Esperanto" },
+	{ "0C", "Estonian" },
+	{ "0D", "Basque" },
+	{ "0E", "Faroese" },
+	{ "0F", "French" },
+	{ "10", "Frisian" },
+	{ "11", "Irish" },
+	{ "12", "Gaelic" },
+	{ "13", "Galacian" },
+	{ "14", "Icelandic" },
+	{ "15", "Italian" },
+	{ "16", "Lappish" },
+	{ "17", "Latin" },
+	{ "18", "Latvian" },
+	{ "19", "Luxemborgian" },
+	{ "1A", "Lithuanian" },
+	{ "1B", "Hungarian" },
+	{ "1C", "Maltese" },
+	{ "1D", "Dutch" },
+	{ "1E", "Norwegian" },
+	{ "1F", "Occitan" },
+	{ "20", "Polish" },
+	{ "21", "Portugese" },
+	{ "22", "Romanian" },
+	{ "23", "Romansh" },
+	{ "24", "Serbian" },
+	{ "25", "Slovak" },
+	{ "26", "Slovenian" },
+	{ "27", "Finnish" },
+	{ "28", "Swedish" },
+	{ "29", "Turkish" },
+	{ "2A", "Flemish" },
+	{ "2B", "Wallon" },
+	{ "7F", "Amharic" },
+	{ "7E", "Arabic" },
+	{ "7D", "Armenian" },
+	{ "7C", "Assamese" },
+	{ "7B", "Azerbaijani" },
+	{ "7A", "Bambora" },
+	{ "79", "Bielorussian" },
+	{ "78", "Bengali" },
+	{ "77", "Bulgarian" },
+	{ "76", "Burmese" },
+	{ "75", "Chinese" },
+	{ "74", "Churash" },
+	{ "73", "Dari" },
+	{ "72", "Fulani" },
+	{ "71", "Georgian" },
+	{ "70", "Greek" },
+	{ "6F", "Gujarati" },
+	{ "6E", "Gurani" },
+	{ "6D", "Hausa" },
+	{ "6C", "Hebrew" },
+	{ "6B", "Hindi" },
+	{ "6A", "Indonesian" },
+	{ "69", "Japanese" },
+	{ "68", "Kannada" },
+	{ "67", "Kazakh" },
+	{ "66", "Khmer" },
+	{ "65", "Korean" },
+	{ "64", "Laotian" },
+	{ "63", "Macedonian" },
+	{ "62", "Malagasay" },
+	{ "61", "Malaysian" },
+	{ "60", "Moldavian" },
+	{ "5F", "Marathi" },
+	{ "5E", "Ndebele" },
+	{ "5D", "Nepali" },
+	{ "5C", "Oriya" },
+	{ "5B", "Papamiento" },
+	{ "5A", "Persian" },
+	{ "59", "Punjabi" },
+	{ "58", "Pushtu" },
+	{ "57", "Quechua" },
+	{ "56", "Russian" },
+	{ "55", "Ruthenian" },
+	{ "54", "Serbo Croat" },
+	{ "53", "Shona" },
+	{ "52", "Sinhalese" },
+	{ "51", "Somali" },
+	{ "50", "Sranan Tongo" },
+	{ "4F", "Swahili" },
+	{ "4E", "Tadzhik" },
+	{ "4D", "Tamil" },
+	{ "4C", "Tatar" },
+	{ "4B", "Telugu" },
+	{ "4A", "Thai" },
+	{ "49", "Ukranian" },
+	{ "48", "Urdu" },
+	{ "47", "Uzbek" },
+	{ "46", "Vietnamese" },
+	{ "45", "Zulu" },
+};
+
+/** Language for each file code, or -1 if the code is not used */
+static int const language_by_code[128] = {
+	LANGUAGE_UNKNOWN, LANGUAGE_ALBANIAN, LANGUAGE_BRETON, LANGUAGE_CATALAN,
+	LANGUAGE_CROATIAN, LANGUAGE_WELSH, LANGUAGE_CZECH, LANGUAGE_DANISH,
+	LANGUAGE_GERMAN, LANGUAGE_ENGLISH, LANGUAGE_SPANISH, LANGUAGE_ESPERANTO,
+	LANGUAGE_ESTONIAN, LANGUAGE_BASQUE, LANGUAGE_FAROESE, LANGUAGE_FRENCH,
+	LANGUAGE_FRISIAN, LANGUAGE_IRISH, LANGUAGE_GAELIC, LANGUAGE_GALACIAN,
+	LANGUAGE_ICELANDIC, LANGUAGE_ITALIAN, LANGUAGE_LAPPISH, LANGUAGE_LATIN,
+	LANGUAGE_LATVIAN, LANGUAGE_LUXEMBORGIAN, LANGUAGE_LITHUANIAN, LANGUAGE_HUNGARIAN,
+	LANGUAGE_MALTESE, LANGUAGE_DUTCH, LANGUAGE_NORWEGIAN, LANGUAGE_OCCITAN,
+	LANGUAGE_POLISH, LANGUAGE_PORTUGESE, LANGUAGE_ROMANIAN, LANGUAGE_ROMANSH,
+	LANGUAGE_SERBIAN, LANGUAGE_SLOVAK, LANGUAGE_SLOVENIAN, LANGUAGE_FINNISH,
+	LANGUAGE_SWEDISH, LANGUAGE_TURKISH, LANGUAGE_FLEMISH, LANGUAGE_WALLON,
+	-1, -1, -1, -1,
+	-1, -1, -1, -1,
+	-1, -1, -1, -1,
+	-1, -1, -1, -1,
+	-1, -1, -1, -1,
+	-1, -1, -1, -1,
+	-1, LANGUAGE_ZULU, LANGUAGE_VIETNAMESE, LANGUAGE_UZBEK,
+	LANGUAGE_URDU, LANGUAGE_UKRANIAN, LANGUAGE_THAI, LANGUAGE_TELUGU,
+	LANGUAGE_TATAR, LANGUAGE_TAMIL, LANGUAGE_TADZHIK, LANGUAGE_SWAHILI,
+	LANGUAGE_SRANAN_TONGO, LANGUAGE_SOMALI, LANGUAGE_SINHALESE, LANGUAGE_SHONA,
+	LANGUAGE_SERBO_CROAT, LANGUAGE_RUTHENIAN, LANGUAGE_RUSSIAN, LANGUAGE_QUECHUA,
+	LANGUAGE_PUSHTU, LANGUAGE_PUNJABI, LANGUAGE_PERSIAN, LANGUAGE_PAPAMIENTO,
+	LANGUAGE_ORIYA, LANGUAGE_NEPALI, LANGUAGE_NDEBELE, LANGUAGE_MARATHI,
+	LANGUAGE_MOLDAVIAN, LANGUAGE_MALAYSIAN, LANGUAGE_MALAGASAY, LANGUAGE_MACEDONIAN,
+	LANGUAGE_LAOTIAN, LANGUAGE_KOREAN, LANGUAGE_KHMER, LANGUAGE_KAZAKH,
+	LANGUAGE_KANNADA, LANGUAGE_JAPANESE, LANGUAGE_INDONESIAN, LANGUAGE_HINDI,
+	LANGUAGE_HEBREW, LANGUAGE_HAUSA, LANGUAGE_GURANI, LANGUAGE_GUJURATI,
+	LANGUAGE_GREEK, LANGUAGE_GEORGIAN, LANGUAGE_FULANI, LANGUAGE_DARI,
+	LANGUAGE_CHURASH, LANGUAGE_CHINESE, LANGUAGE_BURMESE, LANGUAGE_BULGARIAN,
+	LANGUAGE_BENGALI, LANGUAGE_BIELORUSSIAN, LANGUAGE_BAMBORA, LANGUAGE_AZERBAIJANI,
+	LANGUAGE_ASSAMESE, LANGUAGE_ARMENIAN, LANGUAGE_ARABIC, LANGUAGE_AMHARIC,
+};
+
+/** File code and description of each TimecodeStatus */
+static STLBinaryStringCode const timecode_status_codes[] = {
+	{ "0", "Not intended for use" },
+	{ "1", "Intended for use" },
+};
+
+/** Description of each CumulativeStatus */
+static char const * const cumulative_status_descriptions[] = {
+	"Not part of a cumulative set",
+	"First subtitle of a cumulative set",
+	"Intermediate subtitle of a cumulative set",
+	"Last subtitle of a cumulative set",
+};
+
+/** Description of each Justification */
+static char const * const justification_descriptions[] = {
+	"No justification",
+	"Left justification",
+	"Centre justification",
+	"Right justification",
+};
+
+/** Description of each Comment */
+static char const * const comment_descriptions[] = {
+	"Not a comment",
+	"Is a comment",
+};
+
+template <class E, size_t N>
+E
+file_to_enum (string const & k, STLBinaryStringCode const (&codes)[N], string name)
+{
+	for (size_t i = 0; i < N; ++i) {
+		if (k == codes[i].file) {
+			return static_cast<E> (i);
+		}
+	}
+
+	throw STLError (String::compose ("Unknown %1 %2 in binary STL file", name, k));
 }
 
-template <class E, class F>
+template <class E, size_t N>
 E
-file_to_enum (F k, map<F, STLBinaryCode<E> > m, string name)
+file_to_enum (int k, char const * const (&)[N], string name)
 {
-	typename map<F, STLBinaryCode<E> >::const_iterator i = m.find (k);
-	if (i == m.end ()) {
+	if (k < 0 || k >= int (N)) {
 		throw STLError (String::compose ("Unknown %1 %2 in binary STL file", name, k));
 	}
 
-	return i->second.value;
+	return static_cast<E> (k);
 }
 
-template <class E, class F>
-F
-enum_to_file (E k, map<F, STLBinaryCode<E> > m)
+template <class E, size_t N>
+int
+enum_to_file (E v, char const * const (&)[N])
 {
-	for (typename map<F, STLBinaryCode<E> >::const_iterator i = m.begin(); i != m.end(); ++i) {
-		if (i->second.value == k) {
-			return i->first;
-		}
+	SUB_ASSERT (v >= 0 && v < int (N));
+	return v;
+}
+
+template <class E, size_t N>
+string
+enum_to_description (E v, STLBinaryStringCode const (&codes)[N])
+{
+	if (v < 0 || v >= int (N)) {
+		return "";
 	}
 
-	SUB_ASSERT (false);
-	return F ();
+	return codes[v].description;
 }
 
-template <class E, class F>
+template <class E, size_t N>
 string
-enum_to_description (E v, map<F, STLBinaryCode<E> > const & m)
+enum_to_description (E v, char const * const (&descriptions)[N])
 {
-	for (typename map<F, STLBinaryCode<E> >::const_iterator i = m.begin(); i != m.end(); ++i) {
-		if (i->second.value == v) {
-			return i->second.description;
-		}
+	if (v < 0 || v >= int (N)) {
+		return "";
 	}
 
-	return "";
+	return descriptions[v];
 }
 
-template <class E, class F>
-boost::optional<E>
-description_to_enum (string d, map<F, STLBinaryCode<E> > const & m)
+/** @return value of an upper-case hex digit, or -1 */
+static int
+hex_digit (char c)
 {
-	for (typename map<F, STLBinaryCode<E> >::const_iterator i = m.begin(); i != m.end(); ++i) {
-		if (i->second.description == d) {
-			return i->second.value;
-		}
+	if (c >= '0' && c <= '9') {
+		return c - '0';
+	} else if (c >= 'A' && c <= 'F') {
+		return c - 'A' + 10;
 	}
 
-	return boost::optional<E> ();
+	return -1;
 }
 
 DisplayStandard
-STLBinaryTables::display_standard_file_to_enum (string s) const
+STLBinaryTables::display_standard_file_to_enum (string s)
 {
-	return file_to_enum (s, _display_standard_map, "display standard code");
+	return file_to_enum<DisplayStandard> (s, display_standard_codes, "display standard code");
 }
 
 LanguageGroup
-STLBinaryTables::language_group_file_to_enum (string s) const
+STLBinaryTables::language_group_file_to_enum (string s)
 {
-	return file_to_enum (s, _language_group_map, "language group code");
+	return file_to_enum<LanguageGroup> (s, language_group_codes, "language group code");
 }
 
 Language
-STLBinaryTables::language_file_to_enum (string s) const
+STLBinaryTables::language_file_to_enum (string s)
 {
-	return file_to_enum (s, _language_map, "language code");
+	if (s.length() == 2) {
+		int const high = hex_digit (s[0]);
+		int const low = hex_digit (s[1]);
+		if (high >= 0 && high < 8 && low >= 0 && language_by_code[high * 16 + low] >= 0) {
+			return static_cast<Language> (language_by_code[high * 16 + low]);
+		}
+	}
+
+	throw STLError (String::compose ("Unknown language code %1 in binary STL file", s));
 }
 
 TimecodeStatus
-STLBinaryTables::timecode_status_file_to_enum (string s) const
+STLBinaryTables::timecode_status_file_to_enum (string s)
 {
-	return file_to_enum (s, _timecode_status_map, "timecode status code");
+	return file_to_enum<TimecodeStatus> (s, timecode_status_codes, "timecode status code");
 }
 
 CumulativeStatus
-STLBinaryTables::cumulative_status_file_to_enum (int s) const
+STLBinaryTables::cumulative_status_file_to_enum (int s)
 {
-	return file_to_enum (s, _cumulative_status_map, "cumulative status code");
+	return file_to_enum<CumulativeStatus> (s, cumulative_status_descriptions, "cumulative status code");
 }
 
 Justification
-STLBinaryTables::justification_file_to_enum (int s) const
+STLBinaryTables::justification_file_to_enum (int s)
 {
-	return file_to_enum (s, _justification_map, "justification code");
+	return file_to_enum<Justification> (s, justification_descriptions, "justification code");
 }
 
 Comment
-STLBinaryTables::comment_file_to_enum (int s) const
+STLBinaryTables::comment_file_to_enum (int s)
 {
-	return file_to_enum (s, _comment_map, "comment code");
+	return file_to_enum<Comment> (s, comment_descriptions, "comment code");
 }
 
 string
-STLBinaryTables::language_enum_to_file (Language e) const
+STLBinaryTables::language_enum_to_file (Language e)
 {
-	return enum_to_file (e, _language_map);
+	SUB_ASSERT (e >= 0 && e < int (sizeof (language_codes) / sizeof (language_codes[0])));
+	return language_codes[e].file;
 }
 
 int
-STLBinaryTables::cumulative_status_enum_to_file (CumulativeStatus v) const
+STLBinaryTables::cumulative_status_enum_to_file (CumulativeStatus v)
 {
-	return enum_to_file (v, _cumulative_status_map);
+	return enum_to_file (v, cumulative_status_descriptions);
 }
 
 int
-STLBinaryTables::justification_enum_to_file (Justification v) const
+STLBinaryTables::justification_enum_to_file (Justification v)
 {
-	return enum_to_file (v, _justification_map);
+	return enum_to_file (v, justification_descriptions);
 }
 
 int
-STLBinaryTables::comment_enum_to_file (Comment v) const
+STLBinaryTables::comment_enum_to_file (Comment v)
 {
-	return enum_to_file (v, _comment_map);
+	return enum_to_file (v, comment_descriptions);
 }
 
 string
-STLBinaryTables::display_standard_enum_to_description (DisplayStandard v) const
+STLBinaryTables::display_standard_enum_to_description (DisplayStandard v)
 {
-	return enum_to_description (v, _display_standard_map);
+	return enum_to_description (v, display_standard_codes);
 }
 
 string
-STLBinaryTables::language_group_enum_to_description (LanguageGroup v) const
+STLBinaryTables::language_group_enum_to_description (LanguageGroup v)
 {
-	return enum_to_description (v, _language_group_map);
+	return enum_to_description (v, language_group_codes);
 }
 
 string
-STLBinaryTables::language_enum_to_description (Language v) const
+STLBinaryTables::language_enum_to_description (Language v)
 {
-	return enum_to_description (v, _language_map);
+	return enum_to_description (v, language_codes);
 }
 
 string
-STLBinaryTables::timecode_status_enum_to_description (TimecodeStatus v) const
+STLBinaryTables::timecode_status_enum_to_description (TimecodeStatus v)
 {
-	return enum_to_description (v, _timecode_status_map);
+	return enum_to_description (v, timecode_status_codes);
 }
 
 string
-STLBinaryTables::cumulative_status_enum_to_description (CumulativeStatus v) const
+STLBinaryTables::cumulative_status_enum_to_description (CumulativeStatus v)
 {
-	return enum_to_description (v, _cumulative_status_map);
+	return enum_to_description (v, cumulative_status_descriptions);
 }
 
 string
-STLBinaryTables::justification_enum_to_description (Justification v) const
+STLBinaryTables::justification_enum_to_description (Justification v)
 {
-	return enum_to_description (v, _justification_map);
+	return enum_to_description (v, justification_descriptions);
 }
 
 string
-STLBinaryTables::comment_enum_to_description (Comment v) const
+STLBinaryTables::comment_enum_to_description (Comment v)
 {
-	return enum_to_description (v, _comment_map);
+	return enum_to_description (v, comment_descriptions);
 }
 
 boost::optional<Language>
-STLBinaryTables::language_description_to_enum (string d) const
+STLBinaryTables::language_description_to_enum (string d)
 {
-	return description_to_enum (d, _language_map);
-}
+	for (size_t i = 0; i < sizeof (language_codes) / sizeof (language_codes[0]); ++i) {
+		if (d == language_codes[i].description) {
+			return static_cast<Language> (i);
+		}
+	}
 
-STLBinaryTables::STLBinaryTables ()
-{
-	code<DisplayStandard, string> (_display_standard_map, " ", DISPLAY_STANDARD_UNDEFINED, "Undefined");
-	code<DisplayStandard, string> (_display_standard_map, "0", DISPLAY_STANDARD_OPEN_SUBTITLING, "Open subtitling");
-	code<DisplayStandard, string> (_display_standard_map, "1", DISPLAY_STANDARD_LEVEL_1_TELETEXT, "Level 1 teletext");
-	code<DisplayStandard, string> (_display_standard_map, "2", DISPLAY_STANDARD_LEVEL_2_TELETEXT, "Level 2 teletext");
-
-	code<LanguageGroup, string> (_language_group_map, "00", LANGUAGE_GROUP_LATIN, "Latin");
-	code<LanguageGroup, string> (_language_group_map, "01", LANGUAGE_GROUP_LATIN_CYRILLIC, "Latin/Cyrillic");
-	code<LanguageGroup, string> (_language_group_map, "02", LANGUAGE_GROUP_LATIN_ARABIC, "Latin/Arabic");
-	code<LanguageGroup, string> (_language_group_map, "03", LANGUAGE_GROUP_LATIN_GREEK, "Latin/Greek");
-	code<LanguageGroup, string> (_language_group_map, "04", LANGUAGE_GROUP_LATIN_HEBREW, "Latin/Hebrew");
-
-	code<Language, string> (_language_map, "00", LANGUAGE_UNKNOWN, "Unknown");
-	code<Language, string> (_language_map, "01", LANGUAGE_ALBANIAN, "Albanian");
-	code<Language, string> (_language_map, "02", LANGUAGE_BRETON, "Breton");
-	code<Language, string> (_language_map, "03", LANGUAGE_CATALAN, "Catalan");
-	code<Language, string> (_language_map, "04", LANGUAGE_CROATIAN, "Croatian");
-	code<Language, string> (_language_map, "05", LANGUAGE_WELSH, "Welsh");
-	code<Language, string> (_language_map, "06", LANGUAGE_CZECH, "Czech");
-	code<Language, string> (_language_map, "07", LANGUAGE_DANISH, "Danish");
-	code<Language, string> (_language_map, "08", LANGUAGE_GERMAN, "German");
-	code<Language, string> (_language_map, "09", LANGUAGE_ENGLISH, "English");
-	code<Language, string> (_language_map, "0A", LANGUAGE_SPANISH, "Spanish");
-	code<Language, string> (_language_map, "0B", LANGUAGE_ESPERANTO, "Esperanto");
-	code<Language, string> (_language_map, "0C", LANGUAGE_ESTONIAN, "Estonian");
-	code<Language, string> (_language_map, "0D", LANGUAGE_BASQUE, "Basque");
-	code<Language, string> (_language_map, "0E", LANGUAGE_FAROESE, "Faroese");
-	code<Language, string> (_language_map, "0F", LANGUAGE_FRENCH, "French");
-	code<Language, string> (_language_map, "10", LANGUAGE_FRISIAN, "Frisian");
-	code<Language, string> (_language_map, "11", LANGUAGE_IRISH, "Irish");
-	code<Language, string> (_language_map, "12", LANGUAGE_GAELIC, "Gaelic");
-	code<Language, string> (_language_map, "13", LANGUAGE_GALACIAN, "Galacian");
-	code<Language, string> (_language_map, "14", LANGUAGE_ICELANDIC, "Icelandic");
-	code<Language, string> (_language_map, "15", LANGUAGE_ITALIAN, "Italian");
-	code<Language, string> (_language_map, "16", LANGUAGE_LAPPISH, "Lappish");
-	code<Language, string> (_language_map, "17", LANGUAGE_LATIN, "Latin");
-	code<Language, string> (_language_map, "18", LANGUAGE_LATVIAN, "Latvian");
-	code<Language, string> (_language_map, "19", LANGUAGE_LUXEMBORGIAN, "Luxemborgian");
-	code<Language, string> (_language_map, "1A", LANGUAGE_LITHUANIAN, "Lithuanian");
-	code<Language, string> (_language_map, "1B", LANGUAGE_HUNGARIAN, "Hungarian");
-	code<Language, string> (_language_map, "1C", LANGUAGE_MALTESE, "Maltese");
-	code<Language, string> (_language_map, "1D", LANGUAGE_DUTCH, "Dutch");
-	code<Language, string> (_language_map, "1E", LANGUAGE_NORWEGIAN, "Norwegian");
-	code<Language, string> (_language_map, "1F", LANGUAGE_OCCITAN, "Occitan");
-	code<Language, string> (_language_map, "20", LANGUAGE_POLISH, "Polish");
-	code<Language, string> (_language_map, "21", LANGUAGE_PORTUGESE, "Portugese");
-	code<Language, string> (_language_map, "22", LANGUAGE_ROMANIAN, "Romanian");
-	code<Language, string> (_language_map, "23", LANGUAGE_ROMANSH, "Romansh");
-	code<Language, string> (_language_map, "24", LANGUAGE_SERBIAN, "Serbian");
-	code<Language, string> (_language_map, "25", LANGUAGE_SLOVAK, "Slovak");
-	code<Language, string> (_language_map, "26", LANGUAGE_SLOVENIAN, "Slovenian");
-	code<Language, string> (_language_map, "27", LANGUAGE_FINNISH, "Finnish");
-	code<Language, string> (_language_map, "28", LANGUAGE_SWEDISH, "Swedish");
-	code<Language, string> (_language_map, "29", LANGUAGE_TURKISH, "Turkish");
-	code<Language, string> (_language_map, "2A", LANGUAGE_FLEMISH, "Flemish");
-	code<Language, string> (_language_map, "2B", LANGUAGE_WALLON, "Wallon");
-	code<Language, string> (_language_map, "7F", LANGUAGE_AMHARIC, "Amharic");
-	code<Language, string> (_language_map, "7E", LANGUAGE_ARABIC, "Arabic");
-	code<Language, string> (_language_map, "7D", LANGUAGE_ARMENIAN, "Armenian");
-	code<Language, string> (_language_map, "7C", LANGUAGE_ASSAMESE, "Assamese");
-	code<Language, string> (_language_map, "7B", LANGUAGE_AZERBAIJANI, "Azerbaijani");
-	code<Language, string> (_language_map, "7A", LANGUAGE_BAMBORA, "Bambora");
-	code<Language, string> (_language_map, "79", LANGUAGE_BIELORUSSIAN, "Bielorussian");
-	code<Language, string> (_language_map, "78", LANGUAGE_BENGALI, "Bengali");
-	code<Language, string> (_language_map, "77", LANGUAGE_BULGARIAN, "Bulgarian");
-	code<Language, string> (_language_map, "76", LANGUAGE_BURMESE, "Burmese");
-	code<Language, string> (_language_map, "75", LANGUAGE_CHINESE, "Chinese");
-	code<Language, string> (_language_map, "74", LANGUAGE_CHURASH, "Churash");
-	code<Language, string> (_language_map, "73", LANGUAGE_DARI, "Dari");
-	code<Language, string> (_language_map, "72", LANGUAGE_FULANI, "Fulani");
-	code<Language, string> (_language_map, "71", LANGUAGE_GEORGIAN, "Georgian");
-	code<Language, string> (_language_map, "70", LANGUAGE_GREEK, "Greek");
-	code<Language, string> (_language_map, "6F", LANGUAGE_GUJURATI, "Gujarati");
-	code<Language, string> (_language_map, "6E", LANGUAGE_GURANI, "Gurani");
-	code<Language, string> (_language_map, "6D", LANGUAGE_HAUSA, "Hausa");
-	code<Language, string> (_language_map, "6C", LANGUAGE_HEBREW, "Hebrew");
-	code<Language, string> (_language_map, "6B", LANGUAGE_HINDI, "Hindi");
-	code<Language, string> (_language_map, "6A", LANGUAGE_INDONESIAN, "Indonesian");
-	code<Language, string> (_language_map, "69", LANGUAGE_JAPANESE, "Japanese");
-	code<Language, string> (_language_map, "68", LANGUAGE_KANNADA, "Kannada");
-	code<Language, string> (_language_map, "67", LANGUAGE_KAZAKH, "Kazakh");
-	code<Language, string> (_language_map, "66", LANGUAGE_KHMER, "Khmer");
-	code<Language, string> (_language_map, "65", LANGUAGE_KOREAN, "Korean");
-	code<Language, string> (_language_map, "64", LANGUAGE_LAOTIAN, "Laotian");
-	code<Language, string> (_language_map, "63", LANGUAGE_MACEDONIAN, "Macedonian");
-	code<Language, string> (_language_map, "62", LANGUAGE_MALAGASAY, "Malagasay");
-	code<Language, string> (_language_map, "61", LANGUAGE_MALAYSIAN, "Malaysian");
-	code<Language, string> (_language_map, "60", LANGUAGE_MOLDAVIAN, "Moldavian");
-	code<Language, string> (_language_map, "5F", LANGUAGE_MARATHI, "Marathi");
-	code<Language, string> (_language_map, "5E", LANGUAGE_NDEBELE, "Ndebele");
-	code<Language, string> (_language_map, "5D", LANGUAGE_NEPALI, "Nepali");
-	code<Language, string> (_language_map, "5C", LANGUAGE_ORIYA, "Oriya");
-	code<Language, string> (_language_map, "5B", LANGUAGE_PAPAMIENTO, "Papamiento");
-	code<Language, string> (_language_map, "5A", LANGUAGE_PERSIAN, "Persian");
-	code<Language, string> (_language_map, "59", LANGUAGE_PUNJABI, "Punjabi");
-	code<Language, string> (_language_map, "58", LANGUAGE_PUSHTU, "Pushtu");
-	code<Language, string> (_language_map, "57", LANGUAGE_QUECHUA, "Quechua");
-	code<Language, string> (_language_map, "56", LANGUAGE_RUSSIAN, "Russian");
-	code<Language, string> (_language_map, "55", LANGUAGE_RUTHENIAN, "Ruthenian");
-	code<Language, string> (_language_map, "54", LANGUAGE_SERBO_CROAT, "Serbo Croat");
-	code<Language, string> (_language_map, "53", LANGUAGE_SHONA, "Shona");
-	code<Language, string> (_language_map, "52", LANGUAGE_SINHALESE, "Sinhalese");
-	code<Language, string> (_language_map, "51", LANGUAGE_SOMALI, "Somali");
-	code<Language, string> (_language_map, "50", LANGUAGE_SRANAN_TONGO, "Sranan Tongo");
-	code<Language, string> (_language_map, "4F", LANGUAGE_SWAHILI, "Swahili");
-	code<Language, string> (_language_map, "4E", LANGUAGE_TADZHIK, "Tadzhik");
-	code<Language, string> (_language_map, "4D", LANGUAGE_TAMIL, "Tamil");
-	code<Language, string> (_language_map, "4C", LANGUAGE_TATAR, "Tatar");
-	code<Language, string> (_language_map, "4B", LANGUAGE_TELUGU, "Telugu");
-	code<Language, string> (_language_map, "4A", LANGUAGE_THAI, "Thai");
-	code<Language, string> (_language_map, "49", LANGUAGE_UKRANIAN, "Ukranian");
-	code<Language, string> (_language_map, "48", LANGUAGE_URDU, "Urdu");
-	code<Language, string> (_language_map, "47", LANGUAGE_UZBEK, "Uzbek");
-	code<Language, string> (_language_map, "46", LANGUAGE_VIETNAMESE, "Vietnamese");
-	code<Language, string> (_language_map, "45", LANGUAGE_ZULU, "Zulu");
-
-	code<TimecodeStatus, string> (_timecode_status_map, "0", TIMECODE_STATUS_NOT_INTENDED_FOR_USE, "Not intended for use");
-	code<TimecodeStatus, string> (_timecode_status_map, "1", TIMECODE_STATUS_INTENDED_FOR_USE, "Intended for use");
-
-	code<CumulativeStatus, int> (_cumulative_status_map, 0, CUMULATIVE_STATUS_NOT_CUMULATIVE, "Not part of a cumulative set");
-	code<CumulativeStatus, int> (_cumulative_status_map, 1, CUMULATIVE_STATUS_FIRST, "First subtitle of a cumulative set");
-	code<CumulativeStatus, int> (_cumulative_status_map, 2, CUMULATIVE_STATUS_INTERMEDIATE, "Intermediate subtitle of a cumulative set");
-	code<CumulativeStatus, int> (_cumulative_status_map, 3, CUMULATIVE_STATUS_LAST, "Last subtitle of a cumulative set");
-
-	code<Justification, int> (_justification_map, 0, JUSTIFICATION_NONE, "No justification");
-	code<Justification, int> (_justification_map, 1, JUSTIFICATION_LEFT, "Left justification");
-	code<Justification, int> (_justification_map, 2, JUSTIFICATION_CENTRE, "Centre justification");
-	code<Justification, int> (_justification_map, 3, JUSTIFICATION_RIGHT, "Right justification");
-
-	code<Comment, int> (_comment_map, 0, COMMENT_NO, "Not a comment");
-	code<Comment, int> (_comment_map, 1, COMMENT_YES, "Is a comment");
+	return boost::optional<Language> ();
 }
@@ -21,7 +21,6 @@
 #define LIBSUB_STL_BINARY_TABLES_H
 
 #include <string>
-#include <map>
 #include <boost/optional.hpp>
 
 namespace sub {
@@ -171,65 +170,37 @@ enum Comment {
 	COMMENT_YES
 };
 
-/** @class STLBinaryCode
- *  @brief A value of some STL parameter and a human-readable description of what it means.
- */
-template<class T>
-class STLBinaryCode
-{
-public:
-	STLBinaryCode ()
-		: value ((T) 0)
-	{}
-
-	STLBinaryCode (T v, std::string d)
-		: value (v)
-		, description (d)
-	{}
-
-	T value;
-	std::string description;
-};
-
 /** @class STLBinaryTables
- *  @brief A set of conversion tables for STL binary files.
+ *  @brief Conversion tables for STL binary files.
+ *
+ *  The tables are constant arrays indexed by the values of the enums above, so
+ *  looking something up does not need any set-up and is safe from any thread.
  */
 class STLBinaryTables
 {
 public:
-	STLBinaryTables ();
-
-	DisplayStandard display_standard_file_to_enum (std::string) const;
-	LanguageGroup language_group_file_to_enum (std::string) const;
-	Language language_file_to_enum (std::string) const;
-	TimecodeStatus timecode_status_file_to_enum (std::string) const;
-	CumulativeStatus cumulative_status_file_to_enum (int) const;
-	Justification justification_file_to_enum (int) const;
-	Comment comment_file_to_enum (int) const;
-
-	std::string language_enum_to_file (Language) const;
-	int cumulative_status_enum_to_file (CumulativeStatus) const;
-	int justification_enum_to_file (Justification) const;
-	int comment_enum_to_file (Comment) const;
-
-	std::string display_standard_enum_to_description (DisplayStandard) const;
-	std::string language_group_enum_to_description (LanguageGroup) const;
-	std::string language_enum_to_description (Language) const;
-	std::string timecode_status_enum_to_description (TimecodeStatus) const;
-	std::string cumulative_status_enum_to_description (CumulativeStatus) const;
-	std::string justification_enum_to_description (Justification) const;
-	std::string comment_enum_to_description (Comment) const;
-
-	boost::optional<Language> language_description_to_enum (std::string) const;
-
-private:
-	std::map<std::string, STLBinaryCode<DisplayStandard> > _display_standard_map;
-	std::map<std::string, STLBinaryCode<LanguageGroup> > _language_group_map;
-	std::map<std::string, STLBinaryCode<Language> > _language_map;
-	std::map<std::string, STLBinaryCode<TimecodeStatus> > _timecode_status_map;
-	std::map<int, STLBinaryCode<CumulativeStatus> > _cumulative_status_map;
-	std::map<int, STLBinaryCode<Justification> > _justification_map;
-	std::map<int, STLBinaryCode<Comment> > _comment_map;
+	static DisplayStandard display_standard_file_to_enum (std::string);
+	static LanguageGroup language_group_file_to_enum (std::string);
+	static Language language_file_to_enum (std::string);
+	static TimecodeStatus timecode_status_file_to_enum (std::string);
+	static CumulativeStatus cumulative_status_file_to_enum (int);
+	static Justification justification_file_to_enum (int);
+	static Comment comment_file_to_enum (int);
+
+	static std::string language_enum_to_file (Language);
+	static int cumulative_status_enum_to_file (CumulativeStatus);
+	static int justification_enum_to_file (Justification);
+	static int comment_enum_to_file (Comment);
+
+	static std::string display_standard_enum_to_description (DisplayStandard);
+	static std::string language_group_enum_to_description (LanguageGroup);
+	static std::string language_enum_to_description (Language);
+	static std::string timecode_status_enum_to_description (TimecodeStatus);
+	static std::string cumulative_status_enum_to_description (CumulativeStatus);
+	static std::string justification_enum_to_description (Justification);
+	static std::string comment_enum_to_description (Comment);
+
+	static boost::optional<Language> language_description_to_enum (std::string);
 };
 
 }
@@ -0,0 +1,125 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  src/stl_binary_tti.cc
+ *  @brief STLBinaryTTI class.
+ */
+
+#include "stl_binary_tti.h"
+#include "iso6937.h"
+#include <boost/algorithm/string.hpp>
+#include <vector>
+
+using std::list;
+using std::string;
+using std::vector;
+using boost::is_any_of;
+using namespace sub;
+
+/** Make RawSubtitles from some text, using the timing and position in this block.
+ *  @param text Text field of this block, followed by those of any extension blocks.
+ *  @param frame_rate Frame rate from the GSI block.
+ *  @param maximum_rows Maximum number of displayable rows from the GSI block.
+ *  @param subs List to add the RawSubtitles to.
+ */
+void
+STLBinaryTTI::subtitles (string const & text, int frame_rate, int maximum_rows, list<RawSubtitle>& subs) const
+{
+	/* Split the text up into lines (8Ah is a new line) */
+	vector<string> lines;
+	split (lines, text, is_any_of ("\x8a"));
+
+	/* Italic / underline specifications can span lines, so we need to track them
+	   outside the lines loop.
+	*/
+	bool italic = false;
+	bool underline = false;
+
+	for (size_t i = 0; i < lines.size(); ++i) {
+		RawSubtitle sub;
+		sub.from = time_code_in (frame_rate);
+		sub.to = time_code_out (frame_rate);
+		sub.vertical_position.line = vertical_position() + i;
+		sub.vertical_position.lines = maximum_rows;
+		sub.vertical_position.reference = TOP_OF_SCREEN;
+		sub.italic = italic;
+		sub.underline = underline;
+
+		/* XXX: not sure what to do with JC = 0, "unchanged presentation" */
+		switch (justification_code ()) {
+		case 0:
+		case 2:
+			sub.horizontal_position.reference = HORIZONTAL_CENTRE_OF_SCREEN;
+			break;
+		case 1:
+			sub.horizontal_position.reference = LEFT_OF_SCREEN;
+			break;
+		case 3:
+			sub.horizontal_position.reference = RIGHT_OF_SCREEN;
+			break;
+		}
+
+		/* Loop over characters */
+		string run;
+		for (size_t j = 0; j < lines[i].size(); ++j) {
+
+			unsigned char const c = static_cast<unsigned char> (lines[i][j]);
+
+			if (c == 0x8f) {
+				/* Unused space i.e. end of line */
+				break;
+			}
+
+			if (c >= 0x80 && c <= 0x83) {
+				/* Italic or underline control code */
+				sub.text = iso6937_to_utf8 (run.data(), run.size());
+				subs.push_back (sub);
+				run.clear ();
+			}
+
+			switch (c) {
+			case 0x80:
+				italic = true;
+				break;
+			case 0x81:
+				italic = false;
+				break;
+			case 0x82:
+				underline = true;
+				break;
+			case 0x83:
+				underline = false;
+				break;
+			default:
+				run += lines[i][j];
+				break;
+			}
+
+			sub.italic = italic;
+			sub.underline = underline;
+		}
+
+		if (!run.empty ()) {
+			sub.text = iso6937_to_utf8 (run.data(), run.size());
+			subs.push_back (sub);
+		}
+
+		/* XXX: justification */
+	}
+}
@@ -0,0 +1,104 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  src/stl_binary_tti.h
+ *  @brief STLBinaryTTI class.
+ */
+
+#ifndef LIBSUB_STL_BINARY_TTI_H
+#define LIBSUB_STL_BINARY_TTI_H
+
+#include "raw_subtitle.h"
+#include <list>
+#include <string>
+
+namespace sub {
+
+/** @class STLBinaryTTI
+ *  @brief A view of a 128-byte TTI block from a binary STL file.
+ *
+ *  The block's data must outlive this object.
+ */
+class STLBinaryTTI
+{
+public:
+	explicit STLBinaryTTI (unsigned char const * data)
+		: _data (data)
+	{}
+
+	int subtitle_group_number () const {
+		return _data[0];
+	}
+
+	int subtitle_number () const {
+		return _data[1] | (_data[2] << 8);
+	}
+
+	int extension_block_number () const {
+		return _data[3];
+	}
+
+	/** @return true if the next block is an extension block of the same subtitle */
+	bool continued () const {
+		return extension_block_number() < 0xf0;
+	}
+
+	int cumulative_status () const {
+		return _data[4];
+	}
+
+	Time time_code_in (int frame_rate) const {
+		return Time::from_hmsf (_data[5], _data[6], _data[7], _data[8], Rational (frame_rate, 1));
+	}
+
+	Time time_code_out (int frame_rate) const {
+		return Time::from_hmsf (_data[9], _data[10], _data[11], _data[12], Rational (frame_rate, 1));
+	}
+
+	/** @return time code in as a number of frames, for quick comparisons */
+	int time_code_in_frames (int frame_rate) const {
+		return ((_data[5] * 60 + _data[6]) * 60 + _data[7]) * frame_rate + _data[8];
+	}
+
+	int vertical_position () const {
+		return _data[13];
+	}
+
+	int justification_code () const {
+		return _data[14];
+	}
+
+	int comment_flag () const {
+		return _data[15];
+	}
+
+	/** @return the 112-byte text field */
+	std::string text () const {
+		return std::string (reinterpret_cast<char const *> (_data + 16), 112);
+	}
+
+	void subtitles (std::string const & text, int frame_rate, int maximum_rows, std::list<RawSubtitle>& subs) const;
+
+private:
+	unsigned char const * _data;
+};
+
+}
+
+#endif
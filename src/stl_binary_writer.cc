@@ -23,10 +23,12 @@
 
 #include "stl_binary_writer.h"
 #include "subtitle.h"
+#include "flat_document.h"
 #include "iso6937.h"
 #include "stl_util.h"
 #include "compose.hpp"
 #include "sub_assert.h"
+#include "exceptions.h"
 #include <boost/locale.hpp>
 #include <boost/algorithm/string.hpp>
 #include <list>
@@ -36,6 +38,7 @@
 #include <set>
 
 using std::list;
+using std::vector;
 using std::set;
 using std::ofstream;
 using std::string;
@@ -56,6 +59,9 @@ using namespace sub;
  */
 static int const ROWS = 23;
 
+/** Size in bytes of the buffer used to write TTI blocks */
+static size_t const tti_buffer_size = 128 * 512;
+
 static void
 put_string (char* p, string s)
 {
@@ -108,26 +114,26 @@ put_int_as_int (char* p, int v, unsigned int n)
 }
 
 static int
-vertical_position (sub::Line const & line)
+vertical_position (VerticalPosition const & position)
 {
 	int vp = 0;
-	if (line.vertical_position.proportional) {
-		switch (line.vertical_position.reference.get_value_or (TOP_OF_SCREEN)) {
+	if (position.proportional) {
+		switch (position.reference.get_value_or (TOP_OF_SCREEN)) {
 		case TOP_OF_SCREEN:
-			vp = rint (line.vertical_position.proportional.get() * ROWS);
+			vp = rint (position.proportional.get() * ROWS);
 			break;
 		case VERTICAL_CENTRE_OF_SCREEN:
-			vp = rint (line.vertical_position.proportional.get() * ROWS + (ROWS / 2.0));
+			vp = rint (position.proportional.get() * ROWS + (ROWS / 2.0));
 			break;
 		case BOTTOM_OF_SCREEN:
-			vp = rint (ROWS - (line.vertical_position.proportional.get() * ROWS));
+			vp = rint (ROWS - (position.proportional.get() * ROWS));
 			break;
 		default:
 			break;
 		}
-	} else if (line.vertical_position.line) {
-		float const prop = float (line.vertical_position.line.get()) / line.vertical_position.lines.get ();
-		switch (line.vertical_position.reference.get_value_or (TOP_OF_SCREEN)) {
+	} else if (position.line) {
+		float const prop = float (position.line.get()) / position.lines.get ();
+		switch (position.reference.get_value_or (TOP_OF_SCREEN)) {
 		case TOP_OF_SCREEN:
 			vp = prop * ROWS;
 			break;
@@ -145,10 +151,79 @@ vertical_position (sub::Line const & line)
 	return vp;
 }
 
-/** @param language ISO 3-character country code for the language of the subtitles */
-void
-sub::write_stl_binary (
-	list<Subtitle> subtitles,
+/** @class STLTextMaker
+ *  @brief Helper to make the text of a TTI block from lines of blocks of UTF-8.
+ */
+class STLTextMaker
+{
+public:
+	/** @param text String to put the text in */
+	explicit STLTextMaker (string& text)
+		: _text (text)
+		, _italic (false)
+		, _underline (false)
+	{
+		_text.clear ();
+	}
+
+	/** Start a line at vertical position vp */
+	void line (int vp)
+	{
+		/* CR/LF down to this line */
+		if (_last_vp) {
+			for (int i = _last_vp.get(); i < vp; ++i) {
+				_text += "\x8A";
+			}
+		}
+
+		_last_vp = vp;
+	}
+
+	void block (char const * text, size_t size, bool italic, bool underline)
+	{
+		if (underline && !_underline) {
+			_text += "\x82";
+			_underline = true;
+		} else if (_underline && !underline) {
+			_text += "\x83";
+			_underline = false;
+		}
+		if (italic && !_italic) {
+			_text += "\x80";
+			_italic = true;
+		} else if (_italic && !italic) {
+			_text += "\x81";
+			_italic = false;
+		}
+
+		_text += utf16_to_iso6937 (utf_to_utf<wchar_t> (text, text + size));
+	}
+
+	void finish ()
+	{
+		/* Turn italic/underline off before the end of this subtitle */
+
+		if (_underline) {
+			_text += "\x83";
+		}
+
+		if (_italic) {
+			_text += "\x81";
+		}
+	}
+
+private:
+	string& _text;
+	bool _italic;
+	bool _underline;
+	optional<int> _last_vp;
+};
+
+/** @param file_name File to write to; it is opened here, and an exception thrown if it cannot be.
+ *  @param language ISO 3-character country code for the language of the subtitles.
+ */
+STLBinaryWriter::STLBinaryWriter (
+	boost::filesystem::path file_name,
 	float frames_per_second,
 	Language language,
 	string original_programme_title,
@@ -163,9 +238,14 @@ sub::write_stl_binary (
 	string country_of_origin,
 	string publisher,
 	string editor_name,
-	string editor_contact_details,
-	boost::filesystem::path file_name
+	string editor_contact_details
 	)
+	: _frames_per_second (frames_per_second)
+	, _output (file_name.string().c_str(), std::ios::binary)
+	, _tti_blocks (0)
+	, _subtitles (0)
+	, _longest (0)
+	, _closed (false)
 {
 	SUB_ASSERT (original_programme_title.size() <= 32);
 	SUB_ASSERT (original_episode_title.size() <= 32);
@@ -181,185 +261,344 @@ sub::write_stl_binary (
 	SUB_ASSERT (editor_name.size() <= 32);
 	SUB_ASSERT (editor_contact_details.size() <= 32);
 
-	char* buffer = new char[1024];
-	memset (buffer, 0, 1024);
-	ofstream output (file_name.string().c_str ());
-	STLBinaryTables tables;
-
-	/* Find the longest subtitle in characters */
-
-	int longest = 0;
-
-	for (list<Subtitle>::const_iterator i = subtitles.begin(); i != subtitles.end(); ++i) {
-		for (list<Line>::const_iterator j = i->lines.begin(); j != i->lines.end(); ++j) {
-			int t = 0;
-			for (list<Block>::const_iterator k = j->blocks.begin(); k != j->blocks.end(); ++k) {
-				t += k->text.size ();
-			}
-			longest = std::max (longest, t);
-		}
+	if (!_output) {
+		throw FileError (String::compose ("Could not open %1 for writing", file_name.string()));
 	}
 
+	memset (_gsi, 0, sizeof (_gsi));
+
 	/* Code page: 850 */
-	put_string (buffer + 0, "850");
+	put_string (_gsi + 0, "850");
 	/* Disk format code */
-	put_string (buffer + 3, stl_frame_rate_to_dfc (frames_per_second));
+	put_string (_gsi + 3, stl_frame_rate_to_dfc (frames_per_second));
 	/* Display standard code: open subtitling */
-	put_string (buffer + 11, "0");
+	put_string (_gsi + 11, "0");
 	/* Character code table: Latin (ISO 6937) */
-	put_string (buffer + 12, "00");
-	put_string (buffer + 14, tables.language_enum_to_file (language));
-	put_string (buffer + 16, 32, original_programme_title);
-	put_string (buffer + 48, 32, original_episode_title);
-	put_string (buffer + 80, 32, translated_programme_title);
-	put_string (buffer + 112, 32, translated_episode_title);
-	put_string (buffer + 144, 32, translator_name);
-	put_string (buffer + 176, 32, translator_contact_details);
+	put_string (_gsi + 12, "00");
+	put_string (_gsi + 14, STLBinaryTables::language_enum_to_file (language));
+	put_string (_gsi + 16, 32, original_programme_title);
+	put_string (_gsi + 48, 32, original_episode_title);
+	put_string (_gsi + 80, 32, translated_programme_title);
+	put_string (_gsi + 112, 32, translated_episode_title);
+	put_string (_gsi + 144, 32, translator_name);
+	put_string (_gsi + 176, 32, translator_contact_details);
 	/* Subtitle list reference code */
-	put_string (buffer + 208, "0000000000000000");
-	put_string (buffer + 224, creation_date);
-	put_string (buffer + 230, revision_date);
-	put_int_as_string (buffer + 236, revision_number, 2);
-	/* TTI blocks */
-	put_int_as_string (buffer + 238, subtitles.size(), 5);
-	/* Total number of subtitles */
-	put_int_as_string (buffer + 243, subtitles.size(), 5);
+	put_string (_gsi + 208, "0000000000000000");
+	put_string (_gsi + 224, creation_date);
+	put_string (_gsi + 230, revision_date);
+	put_int_as_string (_gsi + 236, revision_number, 2);
+	/* TTI blocks, total number of subtitles and maximum number of displayable
+	   characters in any text row are filled in by close().
+	*/
 	/* Total number of subtitle groups */
-	put_string (buffer + 248, "001");
-	/* Maximum number of displayable characters in any text row */
-	put_int_as_string (buffer + 251, longest, 2);
+	put_string (_gsi + 248, "001");
 	/* Maximum number of displayable rows */
-	put_int_as_string (buffer + 253, ROWS, 2);
+	put_int_as_string (_gsi + 253, ROWS, 2);
 	/* Time code status */
-	put_string (buffer + 255, "1");
+	put_string (_gsi + 255, "1");
 	/* Start-of-programme time code */
-	put_string (buffer + 256, "00000000");
+	put_string (_gsi + 256, "00000000");
 	/* First-in-cue time code */
-	put_string (buffer + 264, "00000000");
+	put_string (_gsi + 264, "00000000");
 	/* Total number of disks */
-	put_string (buffer + 272, "1");
+	put_string (_gsi + 272, "1");
 	/* Disk sequence number */
-	put_string (buffer + 273, "1");
-	put_string (buffer + 274, 3, country_of_origin);
-	put_string (buffer + 277, 32, publisher);
-	put_string (buffer + 309, 32, editor_name);
-	put_string (buffer + 341, 32, editor_contact_details);
+	put_string (_gsi + 273, "1");
+	put_string (_gsi + 274, 3, country_of_origin);
+	put_string (_gsi + 277, 32, publisher);
+	put_string (_gsi + 309, 32, editor_name);
+	put_string (_gsi + 341, 32, editor_contact_details);
+
+	/* Leave space for the GSI block, which is written by close() */
+	_buffer.reserve (tti_buffer_size);
+	_buffer.resize (sizeof (_gsi));
+}
 
-	output.write (buffer, 1024);
+STLBinaryWriter::~STLBinaryWriter ()
+{
+	if (!_closed) {
+		close ();
+	}
+}
 
-	for (list<Subtitle>::const_iterator i = subtitles.begin(); i != subtitles.end(); ++i) {
+void
+STLBinaryWriter::write (Subtitle const & subtitle)
+{
+	if (subtitle.lines.empty ()) {
+		return;
+	}
+
+	/* Find the top vertical position of this subtitle */
+	optional<int> top;
+	for (list<Line>::const_iterator i = subtitle.lines.begin(); i != subtitle.lines.end(); ++i) {
+		int const vp = vertical_position (i->vertical_position);
+		if (!top || vp < top.get ()) {
+			top = vp;
+		}
+	}
+
+	STLTextMaker maker (_text);
+	for (list<Line>::const_iterator i = subtitle.lines.begin(); i != subtitle.lines.end(); ++i) {
+		maker.line (vertical_position (i->vertical_position));
+		int length = 0;
+		for (list<Block>::const_iterator j = i->blocks.begin(); j != i->blocks.end(); ++j) {
+			maker.block (j->text.c_str(), j->text.size(), j->italic, j->underline);
+			length += j->text.size ();
+		}
+		_longest = std::max (_longest, length);
+	}
+	maker.finish ();
+
+	/* XXX: this assumes the first line has the right horizontal position */
+	write_tti (subtitle.from, subtitle.to, top.get(), subtitle.lines.front().horizontal_position.reference);
+}
+
+/** Write all the subtitles in a FlatDocument */
+void
+STLBinaryWriter::write (FlatDocument const & document)
+{
+	for (vector<FlatSubtitle>::const_iterator i = document.subtitles.begin(); i != document.subtitles.end(); ++i) {
+
+		if (i->line_count == 0) {
+			continue;
+		}
+
+		vector<FlatLine>::const_iterator const lines_begin = document.lines.begin() + i->first_line;
+		vector<FlatLine>::const_iterator const lines_end = lines_begin + i->line_count;
 
 		/* Find the top vertical position of this subtitle */
 		optional<int> top;
-		for (list<Line>::const_iterator j = i->lines.begin(); j != i->lines.end(); ++j) {
-			int const vp = vertical_position (*j);
+		for (vector<FlatLine>::const_iterator j = lines_begin; j != lines_end; ++j) {
+			int const vp = vertical_position (j->vertical_position);
 			if (!top || vp < top.get ()) {
 				top = vp;
 			}
 		}
 
-		memset (buffer, 0, 1024);
-
-		/* Subtitle group number */
-		put_int_as_int (buffer + 0, 1, 1);
-		/* Subtitle number */
-		put_int_as_int (buffer + 1, 0, 2);
-		/* Extension block number.  Use 0xff here to indicate that it is the last TTI
-		   block in this subtitle "set", as we only ever use one.
-		*/
-		put_int_as_int (buffer + 3, 255, 1);
-		/* Cumulative status */
-		put_int_as_int (buffer + 4, tables.cumulative_status_enum_to_file (CUMULATIVE_STATUS_NOT_CUMULATIVE), 1);
-		/* Time code in */
-		put_int_as_int (buffer + 5, i->from.hours(), 1);
-		put_int_as_int (buffer + 6, i->from.minutes(), 1);
-		put_int_as_int (buffer + 7, i->from.seconds(), 1);
-		put_int_as_int (buffer + 8, i->from.frames_at(sub::Rational (frames_per_second * 1000, 1000)), 1);
-		/* Time code out */
-		put_int_as_int (buffer + 9, i->to.hours(), 1);
-		put_int_as_int (buffer + 10, i->to.minutes(), 1);
-		put_int_as_int (buffer + 11, i->to.seconds(), 1);
-		put_int_as_int (buffer + 12, i->to.frames_at(sub::Rational (frames_per_second * 1000, 1000)), 1);
-		/* Vertical position */
-		put_int_as_int (buffer + 13, top.get(), 1);
-
-		/* Justification code */
-		/* XXX: this assumes the first line has the right value */
-		switch (i->lines.front().horizontal_position.reference) {
-		case LEFT_OF_SCREEN:
-			put_int_as_int (buffer + 14, tables.justification_enum_to_file (JUSTIFICATION_LEFT), 1);
-			break;
-		case HORIZONTAL_CENTRE_OF_SCREEN:
-			put_int_as_int (buffer + 14, tables.justification_enum_to_file (JUSTIFICATION_CENTRE), 1);
-			break;
-		case RIGHT_OF_SCREEN:
-			put_int_as_int (buffer + 14, tables.justification_enum_to_file (JUSTIFICATION_RIGHT), 1);
-			break;
+		STLTextMaker maker (_text);
+		for (vector<FlatLine>::const_iterator j = lines_begin; j != lines_end; ++j) {
+			maker.line (vertical_position (j->vertical_position));
+			int length = 0;
+			vector<FlatBlock>::const_iterator const blocks_begin = document.blocks.begin() + j->first_block;
+			for (vector<FlatBlock>::const_iterator k = blocks_begin; k != blocks_begin + j->block_count; ++k) {
+				Style const & style = document.style (*k);
+				maker.block (k->text, k->text_size, style.italic, style.underline);
+				length += k->text_size;
+			}
+			_longest = std::max (_longest, length);
 		}
+		maker.finish ();
+
+		/* XXX: this assumes the first line has the right horizontal position */
+		write_tti (i->from, i->to, top.get(), lines_begin->horizontal_position.reference);
+	}
+}
 
-		/* Comment flag */
-		put_int_as_int (buffer + 15, tables.comment_enum_to_file (COMMENT_NO), 1);
+/** Add TTI blocks for a subtitle whose text is in _text to _buffer.  Text which
+ *  will not fit into one block continues into extension blocks.
+ */
+void
+STLBinaryWriter::write_tti (Time const & from, Time const & to, int top, HorizontalReference horizontal_reference)
+{
+	SUB_ASSERT (!_closed);
+
+	char header[16];
+
+	/* Subtitle group number */
+	put_int_as_int (header + 0, 1, 1);
+	/* Subtitle number */
+	put_int_as_int (header + 1, 0, 2);
+	/* Extension block number; filled in below */
+	put_int_as_int (header + 3, 0, 1);
+	/* Cumulative status */
+	put_int_as_int (header + 4, STLBinaryTables::cumulative_status_enum_to_file (CUMULATIVE_STATUS_NOT_CUMULATIVE), 1);
+	/* Time code in */
+	put_int_as_int (header + 5, from.hours(), 1);
+	put_int_as_int (header + 6, from.minutes(), 1);
+	put_int_as_int (header + 7, from.seconds(), 1);
+	put_int_as_int (header + 8, from.frames_at(sub::Rational (_frames_per_second * 1000, 1000)), 1);
+	/* Time code out */
+	put_int_as_int (header + 9, to.hours(), 1);
+	put_int_as_int (header + 10, to.minutes(), 1);
+	put_int_as_int (header + 11, to.seconds(), 1);
+	put_int_as_int (header + 12, to.frames_at(sub::Rational (_frames_per_second * 1000, 1000)), 1);
+	/* Vertical position */
+	put_int_as_int (header + 13, top, 1);
+
+	/* Justification code */
+	switch (horizontal_reference) {
+	case LEFT_OF_SCREEN:
+		put_int_as_int (header + 14, STLBinaryTables::justification_enum_to_file (JUSTIFICATION_LEFT), 1);
+		break;
+	case HORIZONTAL_CENTRE_OF_SCREEN:
+		put_int_as_int (header + 14, STLBinaryTables::justification_enum_to_file (JUSTIFICATION_CENTRE), 1);
+		break;
+	case RIGHT_OF_SCREEN:
+		put_int_as_int (header + 14, STLBinaryTables::justification_enum_to_file (JUSTIFICATION_RIGHT), 1);
+		break;
+	}
 
-		/* Text */
-		string text;
-		bool italic = false;
-		bool underline = false;
-		optional<int> last_vp;
+	/* Comment flag */
+	put_int_as_int (header + 15, STLBinaryTables::comment_enum_to_file (COMMENT_NO), 1);
+
+	/* Text, split into blocks of up to 112 bytes.  Extension blocks are numbered from 0
+	   and the last one is numbered 0xff, so we can have up to 0xf1 blocks.
+	*/
+	size_t start = 0;
+	for (int block = 0; block < 0xf1; ++block) {
+		size_t end = std::min (start + 112, _text.length ());
+		bool const last = end == _text.length() || block == 0xf0;
+		if (!last && static_cast<unsigned char> (_text[end - 1]) >= 0xc1 && static_cast<unsigned char> (_text[end - 1]) <= 0xcf) {
+			/* Don't split a diacritical mark from the letter that it goes with */
+			--end;
+		}
 
-		for (list<Line>::const_iterator j = i->lines.begin(); j != i->lines.end(); ++j) {
+		size_t const offset = _buffer.size ();
+		_buffer.resize (offset + 128);
+		char* buffer = &_buffer[offset];
 
-			/* CR/LF down to this line */
-			int const vp = vertical_position (*j);
+		memcpy (buffer, header, sizeof (header));
+		/* Extension block number, where 0xff means the last block of this subtitle */
+		put_int_as_int (buffer + 3, last ? 0xff : block, 1);
+		memcpy (buffer + 16, _text.c_str() + start, end - start);
+		/* Unused space */
+		memset (buffer + 16 + end - start, 0x8f, 112 - (end - start));
 
-			if (last_vp) {
-				for (int i = last_vp.get(); i < vp; ++i) {
-					text += "\x8A";
-				}
-			}
+		++_tti_blocks;
+		start = end;
 
-			last_vp = vp;
-
-			for (list<Block>::const_iterator k = j->blocks.begin(); k != j->blocks.end(); ++k) {
-				if (k->underline && !underline) {
-					text += "\x82";
-					underline = true;
-				} else if (underline && !k->underline) {
-					text += "\x83";
-					underline = false;
-				}
-				if (k->italic && !italic) {
-					text += "\x80";
-					italic = true;
-				} else if (italic && !k->italic) {
-					text += "\x81";
-					italic = false;
-				}
-
-				text += utf16_to_iso6937 (utf_to_utf<wchar_t> (k->text));
-			}
+		if (last) {
+			break;
 		}
+	}
 
-		/* Turn italic/underline off before the end of this subtitle */
+	++_subtitles;
 
-		if (underline) {
-			text += "\x83";
-		}
+	if (_buffer.size() >= tti_buffer_size) {
+		flush ();
+	}
+}
 
-		if (italic) {
-			text += "\x81";
-		}
+/** Write whatever is in _buffer to the file */
+void
+STLBinaryWriter::flush ()
+{
+	if (!_buffer.empty ()) {
+		_output.write (&_buffer[0], _buffer.size ());
+		_buffer.clear ();
+	}
+}
 
-		if (text.length() > 111) {
-			text = text.substr (111);
-		}
+/** Write any buffered subtitles, fill in the GSI block and close the file */
+void
+STLBinaryWriter::close ()
+{
+	SUB_ASSERT (!_closed);
 
-		while (text.length() < 112) {
-			text += "\x8F";
-		}
+	/* TTI blocks */
+	put_int_as_string (_gsi + 238, _tti_blocks, 5);
+	/* Total number of subtitles */
+	put_int_as_string (_gsi + 243, _subtitles, 5);
+	/* Maximum number of displayable characters in any text row (which only has room for 2 digits) */
+	put_int_as_string (_gsi + 251, std::min (_longest, 99), 2);
+
+	flush ();
+	_output.seekp (0);
+	_output.write (_gsi, sizeof (_gsi));
+
+	_output.close ();
+	_closed = true;
+}
+
+/** Write some Subtitles */
+void
+sub::write_stl_binary (
+	list<Subtitle> subtitles,
+	float frames_per_second,
+	Language language,
+	string original_programme_title,
+	string original_episode_title,
+	string translated_programme_title,
+	string translated_episode_title,
+	string translator_name,
+	string translator_contact_details,
+	string creation_date,
+	string revision_date,
+	int revision_number,
+	string country_of_origin,
+	string publisher,
+	string editor_name,
+	string editor_contact_details,
+	boost::filesystem::path file_name
+	)
+{
+	STLBinaryWriter writer (
+		file_name,
+		frames_per_second,
+		language,
+		original_programme_title,
+		original_episode_title,
+		translated_programme_title,
+		translated_episode_title,
+		translator_name,
+		translator_contact_details,
+		creation_date,
+		revision_date,
+		revision_number,
+		country_of_origin,
+		publisher,
+		editor_name,
+		editor_contact_details
+		);
 
-		put_string (buffer + 16, text);
-		output.write (buffer, 128);
+	for (list<Subtitle>::const_iterator i = subtitles.begin(); i != subtitles.end(); ++i) {
+		writer.write (*i);
 	}
 
-	delete[] buffer;
+	writer.close ();
+}
+
+/** @param language ISO 3-character country code for the language of the subtitles */
+void
+sub::write_stl_binary (
+	FlatDocument const & document,
+	float frames_per_second,
+	Language language,
+	string original_programme_title,
+	string original_episode_title,
+	string translated_programme_title,
+	string translated_episode_title,
+	string translator_name,
+	string translator_contact_details,
+	string creation_date,
+	string revision_date,
+	int revision_number,
+	string country_of_origin,
+	string publisher,
+	string editor_name,
+	string editor_contact_details,
+	boost::filesystem::path file_name
+	)
+{
+	STLBinaryWriter writer (
+		file_name,
+		frames_per_second,
+		language,
+		original_programme_title,
+		original_episode_title,
+		translated_programme_title,
+		translated_episode_title,
+		translator_name,
+		translator_contact_details,
+		creation_date,
+		revision_date,
+		revision_number,
+		country_of_origin,
+		publisher,
+		editor_name,
+		editor_contact_details
+		);
+
+	writer.write (document);
+	writer.close ();
 }
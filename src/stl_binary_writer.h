@@ -25,12 +25,73 @@
 #define LIBSUB_STL_BINARY_WRITER_H
 
 #include "stl_binary_tables.h"
+#include "horizontal_reference.h"
+#include <list>
 #include <string>
+#include <vector>
+#include <fstream>
 #include <boost/filesystem.hpp>
+#include <boost/noncopyable.hpp>
 
 namespace sub {
 
 class Subtitle;
+class FlatDocument;
+class Time;
+
+/** @class STLBinaryWriter
+ *  @brief A class to write binary STL files a subtitle at a time.
+ *
+ *  The file is opened by the constructor, and subtitles given to write() are
+ *  buffered and written in large chunks.  The counts in the GSI block, which
+ *  depend on the subtitles, are filled in by close().
+ */
+class STLBinaryWriter : public boost::noncopyable
+{
+public:
+	STLBinaryWriter (
+		boost::filesystem::path file_name,
+		float frames_per_second,
+		Language language,
+		std::string original_programme_title,
+		std::string original_episode_title,
+		std::string translated_programme_title,
+		std::string translated_episode_title,
+		std::string translator_name,
+		std::string translator_contact_details,
+		std::string creation_date,
+		std::string revision_date,
+		int revision_number,
+		std::string country_of_origin,
+		std::string publisher,
+		std::string editor_name,
+		std::string editor_contact_details
+		);
+
+	~STLBinaryWriter ();
+
+	void write (Subtitle const & subtitle);
+	void write (FlatDocument const & document);
+	void close ();
+
+private:
+	void write_tti (Time const & from, Time const & to, int top, HorizontalReference horizontal_reference);
+	void flush ();
+
+	float _frames_per_second;
+	std::ofstream _output;
+	/** the GSI block */
+	char _gsi[1024];
+	/** TTI blocks which have not yet been written to _output */
+	std::vector<char> _buffer;
+	/** text of the subtitle that is being written */
+	std::string _text;
+	int _tti_blocks;
+	int _subtitles;
+	/** maximum number of characters in any row so far */
+	int _longest;
+	bool _closed;
+};
 
 extern void write_stl_binary (
 	std::list<Subtitle> subtitles,
@@ -52,6 +113,26 @@ extern void write_stl_binary (
 	boost::filesystem::path file_name
 	);
 
+extern void write_stl_binary (
+	FlatDocument const & document,
+	float frames_per_second,
+	Language language,
+	std::string original_programme_title,
+	std::string original_episode_title,
+	std::string translated_programme_title,
+	std::string translated_episode_title,
+	std::string translator_name,
+	std::string translator_contact_details,
+	std::string creation_date,
+	std::string revision_date,
+	int revision_number,
+	std::string country_of_origin,
+	std::string publisher,
+	std::string editor_name,
+	std::string editor_contact_details,
+	boost::filesystem::path file_name
+	);
+
 }
 
 #endif
@@ -19,6 +19,7 @@
 
 #include "stl_text_reader.h"
 #include "compose.hpp"
+#include "line_source.h"
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
 #include <vector>
@@ -37,100 +38,132 @@ using boost::optional;
 using boost::lexical_cast;
 using namespace sub;
 
-STLTextReader::STLTextReader (istream& in)
+STLTextReader::STLTextReader (istream& in, ReadMode mode)
 {
+	start (new StreamLineSource (in), mode);
+}
+
+/** @param data Subtitles, perhaps from a MappedFile; this buffer is not copied,
+ *  so with READ_ON_DEMAND it must outlive the reader.
+ *  @param size Size of data in bytes.
+ */
+STLTextReader::STLTextReader (char const * data, size_t size, ReadMode mode)
+{
+	start (new BufferLineSource (data, size), mode);
+}
+
+/** @param source Source of lines, which we will take ownership of */
+template <class S>
+void
+STLTextReader::start (S* source, ReadMode mode)
+{
+	_source.reset (new ReaderLineSourceImpl<STLTextReader, S> (source));
+
 	/* This reader extracts no information about where the subtitle
 	   should be on screen, so its reference is TOP_OF_SUBTITLE.
 	*/
 	_subtitle.vertical_position.line = 0;
 	_subtitle.vertical_position.reference = TOP_OF_SUBTITLE;
 
-	while (in.good ()) {
-		string line;
-		getline (in, line);
-		if (!in.good ()) {
-			return;
-		}
+	if (mode == READ_ALL) {
+		read_all ();
+	}
+}
 
-		trim (line);
+bool
+STLTextReader::read_more ()
+{
+	return _source->read_more (this);
+}
 
-		if (starts_with (line, "//")) {
-			continue;
-		}
+/** Interpret one line of the source.
+ *  @return true if a subtitle may have been added to _subs.
+ */
+bool
+STLTextReader::process_line (LineView view)
+{
+	view.trim ();
+	string const line = view.to_string ();
 
-		if (line.size() > 0 && line[0] == '$') {
-			/* $ variables */
-			vector<string> bits;
-			split (bits, line, is_any_of ("="));
-			if (bits.size() == 2) {
-				string name = bits[0];
-				trim (name);
-				string value = bits[1];
-				trim (value);
-
-				set (name, value);
-			} else {
-				warn (String::compose ("Unrecognised line %1", line));
-			}
+	if (starts_with (line, "//")) {
+		return false;
+	}
+
+	if (line.size() > 0 && line[0] == '$') {
+		/* $ variables */
+		vector<string> bits;
+		split (bits, line, is_any_of ("="));
+		if (bits.size() == 2) {
+			string name = bits[0];
+			trim (name);
+			string value = bits[1];
+			trim (value);
+
+			set (name, value);
 		} else {
-			/* "Normal" lines */
-			size_t divider[2];
-			divider[0] = line.find_first_of (",");
-			if (divider[0] != string::npos) {
-				divider[1] = line.find_first_of (",", divider[0] + 1);
-			}
+			warn (String::compose ("Unrecognised line %1", line));
+		}
+	} else {
+		/* "Normal" lines */
+		size_t divider[2];
+		divider[0] = line.find_first_of (",");
+		if (divider[0] != string::npos) {
+			divider[1] = line.find_first_of (",", divider[0] + 1);
+		}
 
-			if (divider[0] == string::npos || divider[1] == string::npos || divider[0] <= 1 || divider[1] >= line.length() - 1) {
-				warn (String::compose ("Unrecognised line %1", line));
-				continue;
-			}
+		if (divider[0] == string::npos || divider[1] == string::npos || divider[0] <= 1 || divider[1] >= line.length() - 1) {
+			warn (String::compose ("Unrecognised line %1", line));
+			return false;
+		}
 
-			string from_string = line.substr (0, divider[0] - 1);
-			trim (from_string);
-			string to_string = line.substr (divider[0] + 1, divider[1] - divider[0] - 1);
-			trim (to_string);
+		string from_string = line.substr (0, divider[0] - 1);
+		trim (from_string);
+		string to_string = line.substr (divider[0] + 1, divider[1] - divider[0] - 1);
+		trim (to_string);
 
-			optional<Time> from = time (from_string);
-			optional<Time> to = time (to_string);
+		optional<Time> from = time (from_string);
+		optional<Time> to = time (to_string);
 
-			if (!from || !to) {
-				warn (String::compose ("Unrecognised line %1", line));
-				continue;
-			}
+		if (!from || !to) {
+			warn (String::compose ("Unrecognised line %1", line));
+			return false;
+		}
 
-			_subtitle.from = from.get ();
-			_subtitle.to = to.get ();
-
-			/* Parse ^B/^I/^U */
-			string text = line.substr (divider[1] + 1);
-			for (size_t i = 0; i < text.length(); ++i) {
-				if (text[i] == '|') {
-					maybe_push ();
-					_subtitle.vertical_position.line = _subtitle.vertical_position.line.get() + 1;
-				} else if (text[i] == '^') {
-					maybe_push ();
-					if ((i + 1) < text.length()) {
-						switch (text[i + 1]) {
-						case 'B':
-							_subtitle.bold = !_subtitle.bold;
-							break;
-						case 'I':
-							_subtitle.italic = !_subtitle.italic;
-							break;
-						case 'U':
-							_subtitle.underline = !_subtitle.underline;
-							break;
-						}
+		_subtitle.from = from.get ();
+		_subtitle.to = to.get ();
+
+		/* Parse ^B/^I/^U */
+		string text = line.substr (divider[1] + 1);
+		for (size_t i = 0; i < text.length(); ++i) {
+			if (text[i] == '|') {
+				maybe_push ();
+				_subtitle.vertical_position.line = _subtitle.vertical_position.line.get() + 1;
+			} else if (text[i] == '^') {
+				maybe_push ();
+				if ((i + 1) < text.length()) {
+					switch (text[i + 1]) {
+					case 'B':
+						_subtitle.bold = !_subtitle.bold;
+						break;
+					case 'I':
+						_subtitle.italic = !_subtitle.italic;
+						break;
+					case 'U':
+						_subtitle.underline = !_subtitle.underline;
+						break;
 					}
-					++i;
-				} else {
-					_subtitle.text += text[i];
 				}
+				++i;
+			} else {
+				_subtitle.text += text[i];
 			}
-
-			maybe_push ();
 		}
+
+		maybe_push ();
+		return true;
 	}
+
+	return false;
 }
 
 optional<Time>
@@ -21,7 +21,9 @@
 #define LIBSUB_STL_TEXT_READER_H
 
 #include "reader.h"
+#include "line_source.h"
 #include <boost/optional.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <iostream>
 
 namespace sub {
@@ -32,13 +34,23 @@ namespace sub {
 class STLTextReader : public Reader
 {
 public:
-	STLTextReader (std::istream &);
+	STLTextReader (std::istream &, ReadMode mode = READ_ALL);
+	STLTextReader (char const * data, size_t size, ReadMode mode = READ_ALL);
 
 private:
+	template <class, class>
+	friend class ReaderLineSourceImpl;
+
+	template <class S>
+	void start (S* source, ReadMode mode);
+	bool read_more ();
+	bool process_line (LineView line);
 	void set (std::string name, std::string value);
 	void maybe_push ();
 	boost::optional<Time> time (std::string t) const;
 
+	/** Where our lines come from */
+	boost::scoped_ptr<ReaderLineSource<STLTextReader> > _source;
 	RawSubtitle _subtitle;
 };
 
@@ -0,0 +1,146 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  src/style.cc
+ *  @brief Style and StyleTable classes.
+ */
+
+#include "style.h"
+#include "raw_subtitle.h"
+#include "subtitle.h"
+#include "sub_assert.h"
+#include <boost/functional/hash.hpp>
+
+using namespace sub;
+
+/** Copy the style of a Block or RawSubtitle */
+template <class T>
+static void
+copy_style (Style& style, T const & s)
+{
+	style.font = s.font;
+	style.font_size = s.font_size;
+	style.effect = s.effect;
+	style.effect_colour = s.effect_colour;
+	style.colour = s.colour;
+	style.bold = s.bold;
+	style.italic = s.italic;
+	style.underline = s.underline;
+}
+
+Style::Style (RawSubtitle const & s)
+{
+	copy_style (*this, s);
+}
+
+Style::Style (Block const & b)
+{
+	copy_style (*this, b);
+}
+
+/** Set the style of a Block to this one */
+void
+Style::apply (Block& b) const
+{
+	b.font = font;
+	b.font_size = font_size;
+	b.effect = effect;
+	b.effect_colour = effect_colour;
+	b.colour = colour;
+	b.bold = bold;
+	b.italic = italic;
+	b.underline = underline;
+}
+
+bool
+sub::operator== (Style const & a, Style const & b)
+{
+	return a.font == b.font && a.font_size == b.font_size && a.effect == b.effect && a.effect_colour == b.effect_colour
+		&& a.colour == b.colour && a.bold == b.bold && a.italic == b.italic && a.underline == b.underline;
+}
+
+template <class T>
+static void
+hash_optional (std::size_t& seed, boost::optional<T> const & v)
+{
+	boost::hash_combine (seed, static_cast<bool> (v));
+	if (v) {
+		boost::hash_combine (seed, *v);
+	}
+}
+
+static void
+hash_colour (std::size_t& seed, Colour const & c)
+{
+	boost::hash_combine (seed, c.r);
+	boost::hash_combine (seed, c.g);
+	boost::hash_combine (seed, c.b);
+}
+
+std::size_t
+sub::hash_value (Style const & s)
+{
+	std::size_t seed = 0;
+	hash_optional (seed, s.font);
+	hash_optional (seed, s.font_size.proportional ());
+	hash_optional (seed, s.font_size.points ());
+	boost::hash_combine (seed, static_cast<bool> (s.effect));
+	if (s.effect) {
+		boost::hash_combine (seed, static_cast<int> (*s.effect));
+	}
+	boost::hash_combine (seed, static_cast<bool> (s.effect_colour));
+	if (s.effect_colour) {
+		hash_colour (seed, *s.effect_colour);
+	}
+	hash_colour (seed, s.colour);
+	boost::hash_combine (seed, s.bold);
+	boost::hash_combine (seed, s.italic);
+	boost::hash_combine (seed, s.underline);
+	return seed;
+}
+
+/** @return ID of style, which is added to the table if it is not already there */
+StyleId
+StyleTable::add (Style const & style)
+{
+	boost::unordered_map<Style, StyleId>::const_iterator i = _ids.find (style);
+	if (i != _ids.end ()) {
+		return i->second;
+	}
+
+	StyleId const id = _styles.size ();
+	_styles.push_back (style);
+	_ids[style] = id;
+	return id;
+}
+
+/** @return style with a given ID */
+Style const &
+StyleTable::get (StyleId id) const
+{
+	SUB_ASSERT (id < _styles.size ());
+	return _styles[id];
+}
+
+void
+StyleTable::clear ()
+{
+	_styles.clear ();
+	_ids.clear ();
+}
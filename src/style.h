@@ -0,0 +1,108 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  src/style.h
+ *  @brief Style and StyleTable classes.
+ */
+
+#ifndef LIBSUB_STYLE_H
+#define LIBSUB_STYLE_H
+
+#include "colour.h"
+#include "effect.h"
+#include "font_size.h"
+#include <boost/optional.hpp>
+#include <boost/unordered_map.hpp>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace sub {
+
+class RawSubtitle;
+class Block;
+
+/** Index of a Style in a StyleTable */
+typedef uint32_t StyleId;
+
+/** @class Style
+ *  @brief The appearance of some text: everything about a Block apart from its text.
+ */
+class Style
+{
+public:
+	Style ()
+		: colour (1, 1, 1)
+		, bold (false)
+		, italic (false)
+		, underline (false)
+	{}
+
+	explicit Style (RawSubtitle const & s);
+	explicit Style (Block const & b);
+
+	void apply (Block& b) const;
+
+	boost::optional<std::string> font;
+
+	/** font size */
+	FontSize font_size;
+
+	boost::optional<Effect> effect;
+	boost::optional<Colour> effect_colour;
+
+	Colour colour;
+	bool bold;      ///< true to use a bold version of font
+	bool italic;    ///< true to use an italic version of font
+	bool underline; ///< true to underline
+};
+
+extern bool operator== (Style const & a, Style const & b);
+extern std::size_t hash_value (Style const & s);
+
+/** @class StyleTable
+ *  @brief A set of Styles, each of which is given a StyleId when it is first added.
+ *
+ *  Most tracks use only a few styles, so keeping each once here and referring to
+ *  it by ID saves a lot of memory and makes comparing styles cheap.
+ */
+class StyleTable
+{
+public:
+	StyleId add (Style const & style);
+
+	Style const & get (StyleId id) const;
+
+	/** @return number of distinct styles */
+	size_t size () const {
+		return _styles.size ();
+	}
+
+	void clear ();
+
+private:
+	/** styles, indexed by StyleId */
+	std::vector<Style> _styles;
+	/** IDs of the styles in _styles */
+	boost::unordered_map<Style, StyleId> _ids;
+};
+
+}
+
+#endif
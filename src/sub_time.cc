@@ -31,61 +31,79 @@ using std::setfill;
 using boost::optional;
 using namespace sub;
 
-bool
-sub::operator< (sub::Time const & a, sub::Time const & b)
+int64_t const Time::ticks_per_second;
+
+/** Set up _ticks and _exact from our other members.  We can only use ticks
+ *  if our rate is known and one frame is a whole number of ticks.
+ */
+void
+Time::update_ticks ()
 {
-	if (a._seconds != b._seconds) {
-		return a._seconds < b._seconds;
-	}
+	_exact = false;
+	_ticks = 0;
 
-	if (!a._rate && !b._rate) {
-		/* Can compare if neither has a specified frame rate */
-		return a._frames < b._frames;
+	if (!_rate || _rate->numerator <= 0 || _rate->denominator <= 0) {
+		return;
 	}
 
-	if ((a._rate && !b._rate) || (!a._rate && b._rate)) {
-		throw UnknownFrameRateError ();
+	int64_t const numerator = _rate->numerator;
+	int64_t const denominator = _rate->denominator;
+	if ((ticks_per_second * denominator) % numerator) {
+		return;
 	}
 
-	return (a._frames * a._rate.get().numerator * b._rate.get().denominator) < (b._frames * b._rate.get().numerator * a._rate.get().denominator);
+	_ticks = _seconds * ticks_per_second + _frames * (ticks_per_second * denominator / numerator);
+	_exact = true;
 }
 
+/** @return a's time in seconds multiplied by a's rate numerator and b's rate numerator,
+ *  so that it can be compared exactly with the same thing for b.
+ */
+static int64_t
+cross_scaled (int seconds, int frames, Rational a_rate, Rational b_rate)
+{
+	return (int64_t (seconds) * a_rate.numerator + int64_t (frames) * a_rate.denominator) * b_rate.numerator;
+}
+
+/** Compare two times which cannot both be compared using ticks */
 bool
-sub::operator> (sub::Time const & a, sub::Time const & b)
+sub::less_than_slow (sub::Time const & a, sub::Time const & b)
 {
+	if (a._rate && b._rate) {
+		return cross_scaled (a._seconds, a._frames, *a._rate, *b._rate) < cross_scaled (b._seconds, b._frames, *b._rate, *a._rate);
+	}
+
 	if (a._seconds != b._seconds) {
-		return a._seconds > b._seconds;
+		return a._seconds < b._seconds;
 	}
 
 	if (!a._rate && !b._rate) {
 		/* Can compare if neither has a specified frame rate */
-		return a._frames > b._frames;
+		return a._frames < b._frames;
 	}
 
-	if ((a._rate && !b._rate) || (!a._rate && b._rate)) {
-		throw UnknownFrameRateError ();
-	}
+	throw UnknownFrameRateError ();
+}
 
-	return (a._frames * a._rate.get().numerator * b._rate.get().denominator) > (b._frames * b._rate.get().numerator * a._rate.get().denominator);
+bool
+sub::greater_than_slow (sub::Time const & a, sub::Time const & b)
+{
+	return less_than_slow (b, a);
 }
 
 bool
-sub::operator== (sub::Time const & a, sub::Time const & b)
+sub::equal_slow (sub::Time const & a, sub::Time const & b)
 {
+	if (a._rate && b._rate) {
+		return cross_scaled (a._seconds, a._frames, *a._rate, *b._rate) == cross_scaled (b._seconds, b._frames, *b._rate, *a._rate);
+	}
+
 	if (!a._rate && !b._rate) {
 		/* Can compare if neither has a specified frame rate */
 		return (a._seconds == b._seconds && a._frames == b._frames);
 	}
 
-	if ((a._rate && !b._rate) || (!a._rate && b._rate)) {
-		throw UnknownFrameRateError ();
-	}
-
-	if (a._seconds != b._seconds) {
-		return false;
-	}
-
-	return (a._frames * a._rate.get().numerator * b._rate.get().denominator) == (b._frames * b._rate.get().numerator * a._rate.get().denominator);
+	throw UnknownFrameRateError ();
 }
 
 bool
@@ -172,17 +190,174 @@ Time::all_as_seconds () const
 	return _seconds + double(milliseconds()) / 1000;
 }
 
-/** Add a time to this one.  Both *this and t must have a specified _rate */
+static int64_t
+gcd (int64_t a, int64_t b)
+{
+	if (a < 0) {
+		a = -a;
+	}
+	if (b < 0) {
+		b = -b;
+	}
+	while (b) {
+		int64_t const t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+/** @return floor (n / d) for d > 0 */
+static int64_t
+floor_div (int64_t n, int64_t d)
+{
+	int64_t q = n / d;
+	if ((n % d) != 0 && n < 0) {
+		--q;
+	}
+	return q;
+}
+
+static void
+reduce (int64_t& numerator, int64_t& denominator)
+{
+	int64_t const g = gcd (numerator, denominator);
+	if (g > 1) {
+		numerator /= g;
+		denominator /= g;
+	}
+}
+
+/** Get this time in seconds as an exact fraction; _rate must be specified */
+void
+Time::exact_seconds (int64_t& numerator, int64_t& denominator) const
+{
+	SUB_ASSERT (_rate);
+	SUB_ASSERT (_rate->numerator > 0);
+	SUB_ASSERT (_rate->denominator > 0);
+
+	numerator = int64_t (_seconds) * _rate->numerator + int64_t (_frames) * _rate->denominator;
+	denominator = _rate->numerator;
+	reduce (numerator, denominator);
+}
+
+/** Set this time to numerator / denominator seconds, rounded to the nearest frame
+ *  (with halves going up) at rate, which must be integer.
+ */
+void
+Time::set_exact (int64_t numerator, int64_t denominator, Rational rate)
+{
+	SUB_ASSERT (denominator > 0);
+	SUB_ASSERT (rate.denominator != 0);
+	SUB_ASSERT (rate.integer ());
+
+	reduce (numerator, denominator);
+
+	int64_t const fps = rate.integer_fraction ();
+	int64_t const frames = floor_div (2 * numerator * fps + denominator, 2 * denominator);
+	int64_t const seconds = floor_div (frames, fps);
+
+	_seconds = seconds;
+	_frames = frames - seconds * fps;
+	_rate = rate;
+	update_ticks ();
+}
+
+/** Add a time to this one.  Both *this and t must have a specified _rate, and the
+ *  result is at the larger of the two rates, which must be integer.  The sum is exact
+ *  if it is a whole number of frames at that rate, and otherwise is rounded to the
+ *  nearest frame.
+ */
 void
 Time::add (Time t)
 {
 	SUB_ASSERT (_rate);
 	SUB_ASSERT (t._rate);
 
-	Rational result_rate = max (*_rate, *t._rate);
-	*this = Time::from_frames((all_as_seconds() + t.all_as_seconds()) * result_rate.fraction(), result_rate);
+	int64_t an, ad, bn, bd;
+	exact_seconds (an, ad);
+	t.exact_seconds (bn, bd);
+
+	int64_t const g = gcd (ad, bd);
+	set_exact (an * (bd / g) + bn * (ad / g), ad / g * bd, max (*_rate, *t._rate));
 }
 
+/** Subtract a time from this one, as for add() */
+void
+Time::subtract (Time t)
+{
+	SUB_ASSERT (_rate);
+	SUB_ASSERT (t._rate);
+
+	int64_t an, ad, bn, bd;
+	exact_seconds (an, ad);
+	t.exact_seconds (bn, bd);
+
+	int64_t const g = gcd (ad, bd);
+	set_exact (an * (bd / g) - bn * (ad / g), ad / g * bd, max (*_rate, *t._rate));
+}
+
+/** Multiply this time by r, rounding to the nearest frame at our rate (which must be
+ *  specified and integer) if necessary.  This uses only integer arithmetic, so,
+ *  for example, scaling by 1001/1000 and then by 1000/1001 gives back what we
+ *  started with.
+ */
+void
+Time::scale (Rational r)
+{
+	SUB_ASSERT (r.denominator > 0);
+
+	int64_t n, d;
+	exact_seconds (n, d);
+
+	int64_t rn = r.numerator;
+	int64_t rd = r.denominator;
+	/* Cancel common factors first to keep the numbers small */
+	reduce (n, rd);
+	reduce (rn, d);
+
+	set_exact (n * rn, d * rd, *_rate);
+}
+
+/** Express this time at a different frame rate, which must be integer,
+ *  rounding to the nearest frame at that rate if necessary.
+ */
+void
+Time::convert_rate (Rational rate)
+{
+	int64_t n, d;
+	exact_seconds (n, d);
+	set_exact (n, d, rate);
+}
+
+/** Change this time to this * scale + offset, rounded once to the nearest frame at rate.
+ *  Our rate and offset's rate must be specified, and rate must be integer.
+ */
+void
+Time::retime (Rational scale, Time offset, Rational rate)
+{
+	SUB_ASSERT (scale.numerator >= 0);
+	SUB_ASSERT (scale.denominator > 0);
+
+	int64_t n, d, on, od;
+	exact_seconds (n, d);
+	offset.exact_seconds (on, od);
+
+	/* this * scale as n / d */
+	int64_t sn = scale.numerator;
+	int64_t sd = scale.denominator;
+	reduce (n, sd);
+	reduce (sn, d);
+	n *= sn;
+	d *= sd;
+
+	int64_t const g = gcd (d, od);
+	set_exact (n * (od / g) + on * (d / g), d / g * od, rate);
+}
+
+/** Multiply this time by f using floating point; scale (Rational) is exact and
+ *  should be preferred.
+ */
 void
 Time::scale (float f)
 {
@@ -193,4 +368,5 @@ Time::scale (float f)
 	double const s = Time::all_as_seconds() * f;
 	_seconds = floor (s);
 	_frames = rint ((s - _seconds) * _rate->fraction());
+	update_ticks ();
 }
@@ -22,15 +22,26 @@
 
 #include "rational.h"
 #include <boost/optional.hpp>
+#include <stdint.h>
 
 namespace sub {
 
+/** @class Time
+ *  @brief A time, given as seconds and frames at some (perhaps unknown) rate.
+ *
+ *  Where it can, a Time also keeps itself as a count of ticks on a timebase which is
+ *  an exact multiple of the usual frame rates (and of milliseconds), so that most
+ *  comparisons are a single integer comparison.  Other Times are compared using
+ *  their seconds, frames and rate.
+ */
 class Time
 {
 public:
 	Time ()
 		: _seconds (0)
 		, _frames (0)
+		, _ticks (0)
+		, _exact (false)
 	{}
 
 	int hours () const;
@@ -43,32 +54,92 @@ public:
 	double all_as_seconds () const;
 
 	void add (Time t);
+	void subtract (Time t);
 	void scale (float f);
+	void scale (Rational r);
+	void convert_rate (Rational rate);
+	void retime (Rational scale, Time offset, Rational rate);
+
+	/** @return true if this time is a whole number of ticks (see ticks_per_second) */
+	bool has_ticks () const {
+		return _exact;
+	}
+
+	/** @return this time as a number of ticks; only meaningful if has_ticks() is true */
+	int64_t ticks () const {
+		return _ticks;
+	}
 
 	static Time from_hmsf (int h, int m, int s, int f, boost::optional<Rational> rate = boost::optional<Rational> ());
 	static Time from_hms (int h, int m, int s, int ms);
 	static Time from_frames (int frames, Rational rate);
 
+	/** Number of ticks per second in the timebase that Times use when they can */
+	static int64_t const ticks_per_second = 120000;
+
 private:
 	friend bool operator< (Time const & a, Time const & b);
 	friend bool operator> (Time const & a, Time const & b);
 	friend bool operator== (Time const & a, Time const & b);
 	friend std::ostream& operator<< (std::ostream& s, Time const & t);
+	friend bool less_than_slow (Time const & a, Time const & b);
+	friend bool greater_than_slow (Time const & a, Time const & b);
+	friend bool equal_slow (Time const & a, Time const & b);
 
 	Time (int seconds, int frames, boost::optional<Rational> rate)
 		: _seconds (seconds)
 		, _frames (frames)
 		, _rate (rate)
-	{}
+	{
+		update_ticks ();
+	}
+
+	void update_ticks ();
+	void exact_seconds (int64_t& numerator, int64_t& denominator) const;
+	void set_exact (int64_t numerator, int64_t denominator, Rational rate);
 
 	int _seconds;
 	int _frames;
 	boost::optional<Rational> _rate;
+	/** this time in ticks of ticks_per_second, if _exact is true */
+	int64_t _ticks;
+	/** true if _ticks is exactly this time */
+	bool _exact;
 };
 
-bool operator< (Time const & a, Time const & b);
-bool operator> (Time const & a, Time const & b);
-bool operator== (Time const & a, Time const & b);
+bool less_than_slow (Time const & a, Time const & b);
+bool greater_than_slow (Time const & a, Time const & b);
+bool equal_slow (Time const & a, Time const & b);
+
+/* These are inline since they are used a lot when sorting subtitles */
+
+inline bool
+operator< (Time const & a, Time const & b)
+{
+	if (a._exact & b._exact) {
+		return a._ticks < b._ticks;
+	}
+	return less_than_slow (a, b);
+}
+
+inline bool
+operator> (Time const & a, Time const & b)
+{
+	if (a._exact & b._exact) {
+		return a._ticks > b._ticks;
+	}
+	return greater_than_slow (a, b);
+}
+
+inline bool
+operator== (Time const & a, Time const & b)
+{
+	if (a._exact & b._exact) {
+		return a._ticks == b._ticks;
+	}
+	return equal_slow (a, b);
+}
+
 bool operator!= (Time const & a, Time const & b);
 std::ostream& operator<< (std::ostream& s, Time const & t);
 
@@ -0,0 +1,62 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#ifndef LIBSUB_SUBRIP_COORDINATES_H
+#define LIBSUB_SUBRIP_COORDINATES_H
+
+namespace sub {
+
+/** @class SubripCoordinates
+ *  @brief The box given by X1:, X2:, Y1: and Y2: on a SubRip time line.
+ *
+ *  These are in pixels, but SubRip does not say what the pixels are relative to,
+ *  so they are passed on as they are.
+ */
+class SubripCoordinates
+{
+public:
+	SubripCoordinates ()
+		: x1 (0)
+		, x2 (0)
+		, y1 (0)
+		, y2 (0)
+	{}
+
+	SubripCoordinates (int x1_, int x2_, int y1_, int y2_)
+		: x1 (x1_)
+		, x2 (x2_)
+		, y1 (y1_)
+		, y2 (y2_)
+	{}
+
+	int x1;
+	int x2;
+	int y1;
+	int y2;
+};
+
+inline bool
+operator== (SubripCoordinates const & a, SubripCoordinates const & b)
+{
+	return a.x1 == b.x1 && a.x2 == b.x2 && a.y1 == b.y1 && a.y2 == b.y2;
+}
+
+}
+
+#endif
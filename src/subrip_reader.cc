@@ -24,262 +24,799 @@
 #include "subrip_reader.h"
 #include "exceptions.h"
 #include "util.h"
-#include "sub_assert.h"
-#include "raw_convert.h"
-#include <boost/algorithm/string.hpp>
-#include <boost/lexical_cast.hpp>
-#include <boost/regex.hpp>
+#include "line_source.h"
 #include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cstring>
 #include <cstdio>
 #include <vector>
-#include <iostream>
 
 using std::string;
 using std::vector;
-using std::list;
-using std::cout;
-using std::hex;
-using boost::lexical_cast;
-using boost::to_upper;
 using boost::optional;
-using boost::function;
-using boost::algorithm::replace_all;
 using namespace sub;
 
+/** Split a line at runs of spaces, as boost::split with token_compress_on would.
+ *  @param fields Filled in with up to max fields.
+ *  @return Number of fields in the line, which may be more than max.
+ */
+static int
+split_spaces (LineView line, LineView* fields, int max)
+{
+	char const * p = line.data ();
+	char const * const end = p + line.size ();
+	int n = 0;
+
+	while (true) {
+		char const * start = p;
+		while (p != end && *p != ' ') {
+			++p;
+		}
+		if (n < max) {
+			fields[n] = LineView (start, p - start);
+		}
+		++n;
+		if (p == end) {
+			break;
+		}
+		while (p != end && *p == ' ') {
+			++p;
+		}
+	}
+
+	return n;
+}
+
+/** Parse an integer in the same way as lexical_cast<int>, i.e. an optional sign
+ *  followed by one or more digits, with nothing else.
+ *  @return true if the parse succeeded.
+ */
+static bool
+parse_int (char const * p, char const * end, int& value)
+{
+	bool negative = false;
+	if (p != end && (*p == '-' || *p == '+')) {
+		negative = *p == '-';
+		++p;
+	}
+
+	if (p == end) {
+		return false;
+	}
+
+	/* Accumulate a negative value so that INT_MIN can be represented */
+	int v = 0;
+	for (; p != end; ++p) {
+		if (*p < '0' || *p > '9') {
+			return false;
+		}
+		int const d = *p - '0';
+		if (v < (INT_MIN + d) / 10) {
+			return false;
+		}
+		v = v * 10 - d;
+	}
+
+	if (!negative) {
+		if (v == INT_MIN) {
+			return false;
+		}
+		v = -v;
+	}
+
+	value = v;
+	return true;
+}
+
 /** @param s Subtitle string encoded in UTF-8 */
-SubripReader::SubripReader (string s)
+SubripReader::SubripReader (string s, ReadMode mode)
+	: _state (COUNTER)
+	, _string (s)
 {
-	this->read (boost::bind(&get_line_string, &s));
+	start (new BufferLineSource (_string.data(), _string.size()), mode);
 }
 
 /** @param f Subtitle file encoded in UTF-8 */
-SubripReader::SubripReader (FILE* f)
+SubripReader::SubripReader (FILE* f, ReadMode mode)
+	: _state (COUNTER)
 {
-	this->read (boost::bind (&get_line_file, f));
+	start (new FileLineSource (f), mode);
 }
 
-void
-SubripReader::read (function<optional<string> ()> get_line)
+/** @param data Subtitles encoded in UTF-8, perhaps from a MappedFile; this buffer is
+ *  not copied, so with READ_ON_DEMAND it must outlive the reader.
+ *  @param size Size of data in bytes.
+ *  @param threads Number of threads to read with if mode is READ_ALL, or 0 to use
+ *  as many as there are CPU cores.  Small inputs are always read on the calling thread.
+ */
+SubripReader::SubripReader (char const * data, size_t size, ReadMode mode, int threads)
+	: _state (COUNTER)
 {
-	enum {
-		COUNTER,
-		METADATA,
-		CONTENT
-	} state = COUNTER;
+	if (mode == READ_ALL && threads != 1) {
+		read_parallel (data, size, threads);
+	} else {
+		start (new BufferLineSource (data, size), mode);
+	}
+}
 
-	RawSubtitle rs;
+/** @param source Source of lines, which we will take ownership of */
+template <class S>
+void
+SubripReader::start (S* source, ReadMode mode)
+{
+	_source.reset (new ReaderLineSourceImpl<SubripReader, S> (source));
 
 	/* This reader extracts no information about where the subtitle
 	   should be on screen, so its reference is TOP_OF_SUBTITLE.
 	*/
-	rs.vertical_position.line = 0;
-	rs.vertical_position.reference = TOP_OF_SUBTITLE;
+	_rs.vertical_position.line = 0;
+	_rs.vertical_position.reference = TOP_OF_SUBTITLE;
+
+	reset_tags ();
+
+	if (mode == READ_ALL) {
+		read_all ();
+	}
+}
+
+/** Keep the last few lines that we have seen in case there is an error to report */
+void
+SubripReader::add_context (LineView line)
+{
+	if (_context.size() < 5) {
+		_context.push_back (string ());
+	} else {
+		/* Re-use the oldest line's storage */
+		_context.splice (_context.end(), _context, _context.begin());
+	}
+
+	_context.back().assign (line.data(), line.size());
+}
+
+bool
+SubripReader::read_more ()
+{
+	return _source->read_more (this);
+}
+
+/** @return true if [p, end) is blank as far as process_line() is concerned */
+static bool
+blank (char const * p, char const * end)
+{
+	for (; p != end; ++p) {
+		if (*p != '\r') {
+			return false;
+		}
+	}
+	return true;
+}
 
+/** @return Start of the line after the first blank line which starts after p, or end.
+ *  A SubripReader will always be back in its COUNTER state at this point (or will have
+ *  thrown an exception), so it is safe to start reading from here with a new SubripReader.
+ */
+static char const *
+next_cue_boundary (char const * p, char const * end)
+{
 	while (true) {
-		optional<string> line = get_line ();
-		if (!line) {
-			break;
+		p = static_cast<char const *> (memchr (p, '\n', end - p));
+		if (!p) {
+			return end;
+		}
+		++p;
+		char const * n = static_cast<char const *> (memchr (p, '\n', end - p));
+		if (!n) {
+			return end;
+		}
+		if (blank (p, n)) {
+			return n + 1;
 		}
+	}
+}
+
+/** Smallest piece of a file that read_parallel() will give to a thread */
+static size_t const min_chunk_size = 1024 * 1024;
 
-		trim_right_if (*line, boost::is_any_of ("\n\r"));
-		remove_unicode_bom (line);
+/** Read all of a buffer, splitting it into pieces at cue boundaries and reading
+ *  each piece with a separate SubripReader in its own thread.  The results, and
+ *  any exception, are the same as if the buffer had been read in one go.
+ */
+void
+SubripReader::read_parallel (char const * data, size_t size, int threads)
+{
+	char const * const end = data + size;
+
+	/* Everything is read here, so there will be nothing left for read_more() */
+	start (new BufferLineSource (end, 0), READ_ON_DEMAND);
 
-		/* Keep some history in case there is an error to report */
-		_context.push_back (*line);
-		if (_context.size() > 5) {
-			_context.pop_front ();
+	if (threads <= 0) {
+		threads = std::max (1U, boost::thread::hardware_concurrency ());
+	}
+
+	size_t const wanted = std::min (static_cast<size_t> (threads), std::max (static_cast<size_t> (1), size / min_chunk_size));
+
+	vector<char const *> bounds;
+	bounds.push_back (data);
+	for (size_t i = 1; i < wanted; ++i) {
+		char const * b = next_cue_boundary (std::max (data + size * i / wanted, bounds.back()), end);
+		if (b != end) {
+			bounds.push_back (b);
 		}
+	}
+	bounds.push_back (end);
 
-		switch (state) {
-		case COUNTER:
-		{
-			if (line->empty ()) {
-				/* a blank line at the start is ok */
-				break;
-			}
+	size_t const chunks = bounds.size() - 1;
+	if (chunks == 1) {
+		read_chunk (data, data, end, end);
+		return;
+	}
 
-			state = METADATA;
+	vector<boost::shared_ptr<SubripReader> > readers;
+	vector<int> failed (chunks, 0);
 
-			/* Reset stuff that should not persist across separate subtitles */
-			rs.bold = false;
-			rs.italic = false;
-			rs.underline = false;
-			rs.vertical_position.line = 0;
+	boost::thread_group group;
+	for (size_t i = 0; i < chunks; ++i) {
+		readers.push_back (boost::shared_ptr<SubripReader> (new SubripReader ()));
+		group.create_thread (boost::bind (&SubripReader::read_chunk_in_thread, readers.back().get(), data, bounds[i], bounds[i + 1], end, &failed[i]));
+	}
+	group.join_all ();
+
+	for (size_t i = 0; i < chunks; ++i) {
+		if (failed[i]) {
+			/* Read this chunk again on this thread so that whatever went wrong
+			   is thrown from here.
+			*/
+			readers[i].reset (new SubripReader ());
+			readers[i]->read_chunk (data, bounds[i], bounds[i + 1], end);
 		}
-		break;
-		case METADATA:
-		{
-			vector<string> p;
-
-			/* Further trim this line, removing spaces from the end */
-			trim_right_if (*line, boost::is_any_of (" "));
-
-			boost::algorithm::split (p, *line, boost::algorithm::is_any_of (" "), boost::token_compress_on);
-			if (p.size() != 3 && p.size() != 7) {
-				for (int i = 0; i < 2; ++i) {
-					optional<string> ex = get_line ();
-					if (ex) {
-						_context.push_back (*ex);
-					}
-				}
-				throw SubripError (*line, "a time/position line", _context);
-			}
+		_subs.splice (_subs.end(), readers[i]->_subs);
+	}
+}
+
+/** Read the cues which start in [begin, chunk_end); if there is an error the context
+ *  is taken from before begin and after chunk_end as necessary, as it would be by a
+ *  reader of the whole of [data, end).
+ */
+void
+SubripReader::read_chunk (char const * data, char const * begin, char const * chunk_end, char const * end)
+{
+	/* Pick up the context that a reader of the whole buffer would have had here */
+	LineView previous[5];
+	int n = 0;
+	char const * p = begin;
+	while (n < 5 && p != data) {
+		/* p is the start of a line, so p - 1 is the end of the one before */
+		char const * line_end = p - 1;
+		p = line_end;
+		while (p != data && p[-1] != '\n') {
+			--p;
+		}
+		previous[n] = LineView (p, line_end - p);
+		++n;
+	}
+	for (int i = n - 1; i >= 0; --i) {
+		previous[i].trim_right ("\n\r");
+		remove_unicode_bom (previous[i]);
+		add_context (previous[i]);
+	}
+
+	BufferLineSource* source = new BufferLineSource (begin, end - begin);
+	start (source, READ_ON_DEMAND);
+
+	LineView line;
+	while (source->get (line) && line.data() < chunk_end) {
+		process_line (line);
+	}
+}
+
+void
+SubripReader::read_chunk_in_thread (char const * data, char const * begin, char const * chunk_end, char const * end, int* failed)
+{
+	try {
+		read_chunk (data, begin, chunk_end, end);
+	} catch (...) {
+		*failed = 1;
+	}
+}
 
-			rs.from = convert_time (p[0]);
-			rs.to = convert_time (p[2]);
+/** Interpret one line of the source.
+ *  @return true if a subtitle may have been added to _subs.
+ */
+bool
+SubripReader::process_line (LineView line)
+{
+	line.trim_right ("\n\r");
+	remove_unicode_bom (line);
 
-			/* XXX: should not ignore coordinate specifications */
+	add_context (line);
 
-			state = CONTENT;
+	switch (_state) {
+	case COUNTER:
+	{
+		if (line.empty ()) {
+			/* a blank line at the start is ok */
 			break;
 		}
-		case CONTENT:
-			if (line->empty ()) {
-				state = COUNTER;
-			} else {
-				convert_line (*line, rs);
-				rs.vertical_position.line = rs.vertical_position.line.get() + 1;
+
+		_state = METADATA;
+
+		/* Reset stuff that should not persist across separate subtitles */
+		_rs.bold = false;
+		_rs.italic = false;
+		_rs.underline = false;
+		_rs.colour = Colour (1, 1, 1);
+		_rs.vertical_position.line = 0;
+		reset_tags ();
+	}
+	break;
+	case METADATA:
+	{
+		/* Further trim this line, removing spaces from the end */
+		line.trim_right (" ");
+
+		LineView fields[7];
+		int const n = split_spaces (line, fields, 7);
+		if (n != 3 && n != 7) {
+			string const metadata = line.to_string ();
+			for (int i = 0; i < 2; ++i) {
+				LineView ex;
+				if (_source->get (ex)) {
+					_context.push_back (ex.to_string ());
+				}
 			}
-			break;
+			throw SubripError (metadata, "a time/position line", _context);
+		}
+
+		_rs.from = convert_time (fields[0]);
+		_rs.to = convert_time (fields[2]);
+
+		if (n == 7) {
+			_rs.subrip_coordinates = convert_coordinates (fields + 3);
+		} else {
+			_rs.subrip_coordinates = boost::none;
+		}
+
+		_state = CONTENT;
+		break;
+	}
+	case CONTENT:
+		if (line.empty ()) {
+			_state = COUNTER;
+		} else {
+			convert_line (line, _rs);
+			_rs.vertical_position.line = _rs.vertical_position.line.get() + 1;
+			return true;
 		}
+		break;
 	}
+
+	return false;
 }
 
+/** @param t Time in the format h:m:s,ms */
 Time
-SubripReader::convert_time (string t)
+SubripReader::convert_time (LineView t)
 {
-	vector<string> a;
-	boost::algorithm::split (a, t, boost::is_any_of (":"));
-	if (a.size() != 3) {
-		throw SubripError (t, "time in the format h:m:s,ms", _context);
+	char const * const begin = t.data ();
+	char const * const end = begin + t.size ();
+
+	/* Find the separators; there must be exactly two colons, and then
+	   exactly one comma after the second colon.
+	*/
+	char const * colon[2] = { 0, 0 };
+	char const * comma = 0;
+	int colons = 0;
+	int commas = 0;
+	for (char const * p = begin; p != end; ++p) {
+		if (*p == ':') {
+			if (colons < 2) {
+				colon[colons] = p;
+			}
+			++colons;
+		} else if (*p == ',' && colons >= 2) {
+			if (commas == 0) {
+				comma = p;
+			}
+			++commas;
+		}
 	}
 
-	vector<string> b;
-	boost::algorithm::split (b, a[2], boost::is_any_of (","));
-	if (b.size() != 2) {
-		throw SubripError (t, "time in the format h:m:s,ms", _context);
+	if (colons != 2 || commas != 1) {
+		throw SubripError (t.to_string(), "time in the format h:m:s,ms", _context);
 	}
 
 	int h, m, s, ms;
 
-	try {
-		h = lexical_cast<int>(a[0]);
-	} catch (boost::bad_lexical_cast &) {
-		throw SubripError (t, "integer hour value", _context);
+	if (!parse_int (begin, colon[0], h)) {
+		throw SubripError (t.to_string(), "integer hour value", _context);
 	}
 
-	try {
-		m = lexical_cast<int>(a[1]);
-	} catch (boost::bad_lexical_cast &) {
-		throw SubripError (t, "integer minute value", _context);
+	if (!parse_int (colon[0] + 1, colon[1], m)) {
+		throw SubripError (t.to_string(), "integer minute value", _context);
 	}
 
-	try {
-		s = lexical_cast<int>(b[0]);
-	} catch (boost::bad_lexical_cast &) {
-		throw SubripError (t, "integer second value", _context);
+	if (!parse_int (colon[1] + 1, comma, s)) {
+		throw SubripError (t.to_string(), "integer second value", _context);
 	}
 
-	try {
-		ms = lexical_cast<int>(b[1]);
-	} catch (boost::bad_lexical_cast &) {
-		throw SubripError (t, "integer millisecond value", _context);
+	if (!parse_int (comma + 1, end, ms)) {
+		throw SubripError (t.to_string(), "integer millisecond value", _context);
 	}
 
 	return Time::from_hms (h, m, s, ms);
 }
 
-void
-SubripReader::convert_line (string t, RawSubtitle& p)
+/** @param fields Four fields such as X1:100 in any order (and in either case).
+ *  @return Coordinates, or an empty optional if the fields do not give all four
+ *  of X1, X2, Y1 and Y2.
+ */
+optional<SubripCoordinates>
+SubripReader::convert_coordinates (LineView const * fields) const
 {
-	enum {
-		TEXT,
-		TAG
-	} state = TEXT;
+	SubripCoordinates c;
+	int found = 0;
 
-	string tag;
+	for (int i = 0; i < 4; ++i) {
+		LineView const & f = fields[i];
+		if (f.size() < 4 || f[2] != ':' || (f[1] != '1' && f[1] != '2')) {
+			return optional<SubripCoordinates> ();
+		}
 
-	list<Colour> colours;
-	colours.push_back (Colour (1, 1, 1));
+		int* target = 0;
+		int bit = 0;
+		switch (f[0]) {
+		case 'x':
+		case 'X':
+			target = f[1] == '1' ? &c.x1 : &c.x2;
+			bit = f[1] == '1' ? 1 : 2;
+			break;
+		case 'y':
+		case 'Y':
+			target = f[1] == '1' ? &c.y1 : &c.y2;
+			bit = f[1] == '1' ? 4 : 8;
+			break;
+		default:
+			return optional<SubripCoordinates> ();
+		}
 
-	/* XXX: missing <font> support */
-	/* XXX: nesting of tags e.g. <b>foo<i>bar<b>baz</b>fred</i>jim</b> might
-	   not work, I think.
-	*/
+		if (!parse_int (f.data() + 3, f.data() + f.size(), *target)) {
+			return optional<SubripCoordinates> ();
+		}
+		found |= bit;
+	}
 
-	for (size_t i = 0; i < t.size(); ++i) {
-		switch (state) {
-		case TEXT:
-			if (t[i] == '<' || t[i] == '{') {
-				state = TAG;
-			} else {
-				p.text += t[i];
-			}
+	if (found != 15) {
+		return optional<SubripCoordinates> ();
+	}
+
+	return c;
+}
+
+/** Add some text to a subtitle, stripping Unicode U+202B (right-to-left embedding)
+ *  as sometimes it is rendered as a missing character.  This may be a hack.
+ */
+static void
+append_text (string& text, char const * p, char const * end)
+{
+	static char const rle[] = "\xe2\x80\xab";
+
+	while (true) {
+		char const * r = std::search (p, end, rle, rle + 3);
+		text.append (p, r);
+		if (r == end) {
 			break;
-		case TAG:
-			if (t[i] == '>' || t[i] == '}') {
-				if (tag == "b") {
-					maybe_content (p);
-					p.bold = true;
-				} else if (tag == "/b") {
-					maybe_content (p);
-					p.bold = false;
-				} else if (tag == "i") {
-					maybe_content (p);
-					p.italic = true;
-				} else if (tag == "/i") {
-					maybe_content (p);
-					p.italic = false;
-				} else if (tag == "u") {
-					maybe_content (p);
-					p.underline = true;
-				} else if (tag == "/u") {
-					maybe_content (p);
-					p.underline = false;
-				} else if (boost::starts_with (tag, "font")) {
-					maybe_content (p);
-					boost::regex re (".*color=\"#([[:xdigit:]]+)\"");
-					boost::smatch match;
-					if (boost::regex_search (tag, match, re) && string (match[1]).size() == 6) {
-						p.colour = Colour::from_rgb_hex (match[1]);
-						colours.push_back (p.colour);
-					} else {
-						re = boost::regex (
-							".*color=\"rgba\\("
-							"[[:space:]]*([[:digit:]]+)[[:space:]]*,"
-							"[[:space:]]*([[:digit:]]+)[[:space:]]*,"
-							"[[:space:]]*([[:digit:]]+)[[:space:]]*,"
-							"[[:space:]]*([[:digit:]]+)[[:space:]]*"
-							"\\)\""
-							);
-						if (boost::regex_search (tag, match, re) && match.size() == 5) {
-							p.colour.r = raw_convert<int>(string(match[1])) / 255.0;
-							p.colour.g = raw_convert<int>(string(match[2])) / 255.0;
-							p.colour.b = raw_convert<int>(string(match[3])) / 255.0;
-							colours.push_back (p.colour);
-						} else {
-							throw SubripError (tag, "a colour in the format #rrggbb or rgba(rr,gg,bb,aa)", _context);
-						}
-					}
-				} else if (tag == "/font") {
-					maybe_content (p);
-					SUB_ASSERT (!colours.empty());
-					colours.pop_back ();
-					p.colour = colours.back ();
+		}
+		p = r + 3;
+	}
+}
+
+static char
+lower (char c)
+{
+	return (c >= 'A' && c <= 'Z') ? (c - 'A' + 'a') : c;
+}
+
+/** @return true if [p, end) is the same as the lower-case string s, ignoring case */
+static bool
+iequals (char const * p, char const * end, char const * s)
+{
+	for (; p != end && *s; ++p, ++s) {
+		if (lower (*p) != *s) {
+			return false;
+		}
+	}
+
+	return p == end && *s == '\0';
+}
+
+static int
+hex_digit (char c)
+{
+	if (c >= '0' && c <= '9') {
+		return c - '0';
+	}
+	c = lower (c);
+	if (c >= 'a' && c <= 'f') {
+		return c - 'a' + 10;
+	}
+	return -1;
+}
+
+static char const *
+skip_spaces (char const * p, char const * end)
+{
+	while (p != end && isspace (static_cast<unsigned char> (*p))) {
+		++p;
+	}
+	return p;
+}
+
+struct NamedColour
+{
+	char const * name;
+	int r;
+	int g;
+	int b;
+};
+
+/** Colour names that we accept in <font color="..."> */
+static NamedColour const named_colours[] = {
+	{ "white",   255, 255, 255 },
+	{ "black",     0,   0,   0 },
+	{ "red",     255,   0,   0 },
+	{ "lime",      0, 255,   0 },
+	{ "blue",      0,   0, 255 },
+	{ "yellow",  255, 255,   0 },
+	{ "aqua",      0, 255, 255 },
+	{ "cyan",      0, 255, 255 },
+	{ "fuchsia", 255,   0, 255 },
+	{ "magenta", 255,   0, 255 },
+	{ "silver",  192, 192, 192 },
+	{ "gray",    128, 128, 128 },
+	{ "grey",    128, 128, 128 },
+	{ "maroon",  128,   0,   0 },
+	{ "olive",   128, 128,   0 },
+	{ "green",     0, 128,   0 },
+	{ "purple",  128,   0, 128 },
+	{ "teal",      0, 128, 128 },
+	{ "navy",      0,   0, 128 },
+	{ "orange",  255, 165,   0 },
+};
+
+/** Parse a colour from a <font color="..."> tag; it can be #rrggbb, rgb(r, g, b),
+ *  rgba(r, g, b, a) or one of named_colours.
+ *  @return true if the parse succeeded.
+ */
+static bool
+parse_colour (char const * p, char const * end, Colour& colour)
+{
+	if (end - p == 7 && *p == '#') {
+		int c[6];
+		for (int i = 0; i < 6; ++i) {
+			c[i] = hex_digit (p[i + 1]);
+			if (c[i] < 0) {
+				return false;
+			}
+		}
+		colour = Colour ((c[0] * 16 + c[1]) / 255.0, (c[2] * 16 + c[3]) / 255.0, (c[4] * 16 + c[5]) / 255.0);
+		return true;
+	}
+
+	char const * bracket = std::find (p, end, '(');
+	if (bracket != end) {
+		int count;
+		if (iequals (p, bracket, "rgba")) {
+			count = 4;
+		} else if (iequals (p, bracket, "rgb")) {
+			count = 3;
+		} else {
+			return false;
+		}
+
+		/* Components are 0-255; any alpha is ignored */
+		int c[4];
+		p = bracket + 1;
+		for (int i = 0; i < count; ++i) {
+			p = skip_spaces (p, end);
+			char const * digits = p;
+			c[i] = 0;
+			while (p != end && *p >= '0' && *p <= '9' && p - digits < 4) {
+				c[i] = c[i] * 10 + *p - '0';
+				++p;
+			}
+			if (p == digits) {
+				return false;
+			}
+			p = skip_spaces (p, end);
+			if (p == end || *p != (i == count - 1 ? ')' : ',')) {
+				return false;
+			}
+			++p;
+		}
+
+		if (p != end) {
+			return false;
+		}
+
+		colour = Colour (c[0] / 255.0, c[1] / 255.0, c[2] / 255.0);
+		return true;
+	}
+
+	for (size_t i = 0; i < sizeof (named_colours) / sizeof (named_colours[0]); ++i) {
+		if (iequals (p, end, named_colours[i].name)) {
+			NamedColour const & n = named_colours[i];
+			colour = Colour (n.r / 255.0, n.g / 255.0, n.b / 255.0);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/** Find the value of an attribute in a tag.
+ *  @param p Start of the attributes.
+ *  @param end End of the tag.
+ *  @param name Name of the attribute, in lower case.
+ *  @param value_begin Filled in with the start of the value, without any quotes.
+ *  @param value_end Filled in with the end of the value.
+ *  @return true if the attribute was found.
+ */
+static bool
+find_attribute (char const * p, char const * end, char const * name, char const *& value_begin, char const *& value_end)
+{
+	size_t const name_length = strlen (name);
+
+	while (true) {
+		p = skip_spaces (p, end);
+		if (p == end) {
+			return false;
+		}
+
+		char const * n = p;
+		while (p != end && *p != '=' && !isspace (static_cast<unsigned char> (*p))) {
+			++p;
+		}
+		char const * const n_end = p;
+
+		p = skip_spaces (p, end);
+		if (p == end || *p != '=') {
+			/* Attribute with no value */
+			continue;
+		}
+		p = skip_spaces (p + 1, end);
+
+		char const * v = p;
+		char const * v_end;
+		if (p != end && (*p == '"' || *p == '\'')) {
+			char const quote = *p;
+			v = p + 1;
+			v_end = std::find (v, end, quote);
+			p = v_end == end ? end : v_end + 1;
+		} else {
+			while (p != end && !isspace (static_cast<unsigned char> (*p))) {
+				++p;
+			}
+			v_end = p;
+		}
+
+		if (static_cast<size_t> (n_end - n) == name_length && iequals (n, n_end, name)) {
+			value_begin = v;
+			value_end = v_end;
+			return true;
+		}
+	}
+}
+
+/** Tags which just turn a flag on and off; the order matches _tag_depth */
+static char const * const simple_tags[] = { "b", "i", "u" };
+static bool RawSubtitle::* const simple_tag_flags[] = { &RawSubtitle::bold, &RawSubtitle::italic, &RawSubtitle::underline };
+
+void
+SubripReader::reset_tags ()
+{
+	for (int i = 0; i < 3; ++i) {
+		_tag_depth[i] = 0;
+	}
+	_colours.clear ();
+}
+
+/** Interpret a tag and change p accordingly.
+ *  @param begin First character inside the tag's brackets.
+ *  @param end The closing bracket.
+ */
+void
+SubripReader::convert_tag (char const * begin, char const * end, RawSubtitle& p)
+{
+	bool closing = false;
+	if (begin != end && *begin == '/') {
+		closing = true;
+		++begin;
+	}
+
+	char const * name_end = begin;
+	while (name_end != end && !isspace (static_cast<unsigned char> (*name_end))) {
+		++name_end;
+	}
+
+	for (int i = 0; i < 3; ++i) {
+		if (iequals (begin, name_end, simple_tags[i])) {
+			maybe_content (p);
+			if (closing) {
+				if (_tag_depth[i] > 0) {
+					--_tag_depth[i];
 				}
-				tag.clear ();
-				state = TEXT;
 			} else {
-				tag += tolower (t[i]);
+				++_tag_depth[i];
 			}
-			break;
+			p.*simple_tag_flags[i] = _tag_depth[i] > 0;
+			return;
 		}
 	}
 
-	/* Strip Unicode U+202B (right-to-left embedding) as sometimes it is rendered
-	   as a missing character.  This may be a hack.
-	*/
-	replace_all (p.text, "\xe2\x80\xab", "");
+	if (!iequals (begin, name_end, "font")) {
+		/* Unknown tags are ignored */
+		return;
+	}
+
+	maybe_content (p);
+
+	if (closing) {
+		if (_colours.empty ()) {
+			p.colour = Colour (1, 1, 1);
+		} else {
+			p.colour = _colours.back ();
+			_colours.pop_back ();
+		}
+		return;
+	}
+
+	_colours.push_back (p.colour);
+
+	char const * value;
+	char const * value_end;
+	if (find_attribute (name_end, end, "color", value, value_end) && !parse_colour (value, value_end, p.colour)) {
+		throw SubripError (string (begin, end), "a colour in the format #rrggbb or rgba(rr,gg,bb,aa)", _context);
+	}
+}
+
+/** Convert a line of subtitle text, which may contain tags such as <b>, <i>, <u>
+ *  (or {b} etc.) and <font color="...">, adding RawSubtitles to _subs.
+ *  @param p Subtitle to use as a template; its style is changed by any tags
+ *  in the line, and its text is used up.
+ */
+void
+SubripReader::convert_line (LineView t, RawSubtitle& p)
+{
+	char const * i = t.data ();
+	char const * const end = i + t.size ();
+
+	while (i != end) {
+		char const * tag = i;
+		while (tag != end && *tag != '<' && *tag != '{') {
+			++tag;
+		}
+
+		append_text (p.text, i, tag);
+		if (tag == end) {
+			break;
+		}
+
+		char const * tag_end = tag + 1;
+		while (tag_end != end && *tag_end != '>' && *tag_end != '}') {
+			++tag_end;
+		}
+
+		if (tag_end == end) {
+			/* Unterminated tag; ignore the rest of the line */
+			break;
+		}
+
+		convert_tag (tag + 1, tag_end, p);
+		i = tag_end + 1;
+	}
 
 	maybe_content (p);
 }
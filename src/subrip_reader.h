@@ -25,7 +25,9 @@
 #define LIBSUB_SUBRIP_READER_H
 
 #include "reader.h"
-#include <boost/function.hpp>
+#include "line_source.h"
+#include <boost/scoped_ptr.hpp>
+#include <vector>
 
 struct subrip_reader_convert_line_test;
 struct subrip_reader_convert_time_test;
@@ -36,21 +38,55 @@ namespace sub {
 class SubripReader : public Reader
 {
 public:
-	SubripReader (FILE* f);
-	SubripReader (std::string subs);
+	SubripReader (FILE* f, ReadMode mode = READ_ALL);
+	SubripReader (std::string subs, ReadMode mode = READ_ALL);
+	SubripReader (char const * data, size_t size, ReadMode mode = READ_ALL, int threads = 1);
 
 private:
 	/* For tests */
 	friend struct ::subrip_reader_convert_line_test;
 	friend struct ::subrip_reader_convert_time_test;
 	friend struct ::subrip_reader_test5;
-	SubripReader () {}
+	SubripReader ()
+		: _state (COUNTER)
+	{
+		reset_tags ();
+	}
 
-	Time convert_time (std::string t);
-	void convert_line (std::string t, RawSubtitle& p);
+	Time convert_time (LineView t);
+	boost::optional<SubripCoordinates> convert_coordinates (LineView const * fields) const;
+	void convert_line (LineView t, RawSubtitle& p);
+	void convert_tag (char const * begin, char const * end, RawSubtitle& p);
 	void maybe_content (RawSubtitle& p);
-	void read (boost::function<boost::optional<std::string> ()> get_line);
+	void reset_tags ();
+	template <class, class>
+	friend class ReaderLineSourceImpl;
 
+	template <class S>
+	void start (S* source, ReadMode mode);
+	bool read_more ();
+	void read_parallel (char const * data, size_t size, int threads);
+	void read_chunk (char const * data, char const * begin, char const * chunk_end, char const * end);
+	void read_chunk_in_thread (char const * data, char const * begin, char const * chunk_end, char const * end, int* failed);
+	bool process_line (LineView line);
+	void add_context (LineView line);
+
+	enum {
+		COUNTER,
+		METADATA,
+		CONTENT
+	} _state;
+
+	/** Our copy of the subtitles if we were given them as a string */
+	std::string _string;
+	/** Where our lines come from */
+	boost::scoped_ptr<ReaderLineSource<SubripReader> > _source;
+	/** Subtitle that we are currently building */
+	RawSubtitle _rs;
+	/** Number of <b>, <i> and <u> tags (in that order) that are open in the current subtitle */
+	int _tag_depth[3];
+	/** Colours to go back to at each </font> in the current subtitle */
+	std::vector<Colour> _colours;
 	std::list<std::string> _context;
 };
 
@@ -21,7 +21,7 @@
 
 using namespace sub;
 
-Subtitle::Subtitle (RawSubtitle s)
+Subtitle::Subtitle (RawSubtitle const & s)
 	: from (s.from)
 	, to (s.to)
 	, fade_up (s.fade_up)
@@ -31,12 +31,12 @@ Subtitle::Subtitle (RawSubtitle s)
 }
 
 bool
-Subtitle::same_metadata (RawSubtitle s) const
+Subtitle::same_metadata (RawSubtitle const & s) const
 {
 	return from == s.from && to == s.to && fade_up == s.fade_up && fade_down == s.fade_down;
 }
 
-Line::Line (RawSubtitle s)
+Line::Line (RawSubtitle const & s)
 	: horizontal_position (s.horizontal_position)
 	, vertical_position (s.vertical_position)
 {
@@ -44,12 +44,12 @@ Line::Line (RawSubtitle s)
 }
 
 bool
-Line::same_metadata (RawSubtitle s) const
+Line::same_metadata (RawSubtitle const & s) const
 {
 	return vertical_position == s.vertical_position;
 }
 
-Block::Block (RawSubtitle s)
+Block::Block (RawSubtitle const & s)
 	: text (s.text)
 	, font (s.font)
 	, font_size (s.font_size)
@@ -49,7 +49,7 @@ public:
 	{}
 
 	/** Construct a Block taking any relevant information from a RawSubtitle */
-	Block (RawSubtitle s);
+	Block (RawSubtitle const & s);
 
 	/** Subtitle text in UTF-8 */
 	std::string text;
@@ -83,7 +83,7 @@ public:
 	}
 
 	/** Construct a Line taking any relevant information from a RawSubtitle */
-	Line (RawSubtitle s);
+	Line (RawSubtitle const & s);
 
 	HorizontalPosition horizontal_position;
 
@@ -92,7 +92,7 @@ public:
 
 	std::list<Block> blocks;
 
-	bool same_metadata (RawSubtitle) const;
+	bool same_metadata (RawSubtitle const &) const;
 };
 
 extern bool operator== (Line const & a, Line const & b);
@@ -110,7 +110,7 @@ public:
 	{}
 
 	/** Construct a Line taking any relevant information from a RawSubtitle */
-	Subtitle (RawSubtitle s);
+	Subtitle (RawSubtitle const & s);
 
 	/** from time */
 	Time from;
@@ -122,7 +122,7 @@ public:
 
 	std::list<Line> lines;
 
-	bool same_metadata (RawSubtitle) const;
+	bool same_metadata (RawSubtitle const &) const;
 };
 
 extern bool operator== (Subtitle const & a, Subtitle const & b);
@@ -0,0 +1,78 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  src/timeline.cc
+ *  @brief Timeline class.
+ */
+
+#include "timeline.h"
+
+using std::vector;
+using namespace sub;
+
+/** @param t Time.
+ *  @param indices Filled in with the indices of the subtitles that are on screen at t.
+ */
+void
+Timeline::at (Time t, vector<size_t>& indices) const
+{
+	indices.clear ();
+	_tree.at (t, indices);
+	for (vector<size_t>::iterator i = indices.begin(); i != indices.end(); ++i) {
+		*i = _tree.index (*i);
+	}
+}
+
+/** @param from Start of a period.
+ *  @param to End of the period, which is not included in it.
+ *  @param indices Filled in with the indices of the subtitles that are on screen at
+ *  any time in the period.
+ */
+void
+Timeline::during (Time from, Time to, vector<size_t>& indices) const
+{
+	indices.clear ();
+	_tree.during (from, to, indices);
+	for (vector<size_t>::iterator i = indices.begin(); i != indices.end(); ++i) {
+		*i = _tree.index (*i);
+	}
+}
+
+Timeline::Cursor::Cursor (Timeline const & timeline)
+	: _timeline (timeline)
+	, _cursor (timeline._tree)
+{
+
+}
+
+/** @return Indices of the subtitles that are on screen at t, which are valid until the
+ *  next call to at().
+ */
+vector<size_t> const &
+Timeline::Cursor::at (Time t)
+{
+	vector<size_t> const & active = _cursor.move (t);
+
+	_indices.clear ();
+	for (vector<size_t>::const_iterator i = active.begin(); i != active.end(); ++i) {
+		_indices.push_back (_timeline._tree.index (*i));
+	}
+
+	return _indices;
+}
@@ -0,0 +1,105 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  src/timeline.h
+ *  @brief Timeline class.
+ */
+
+#ifndef LIBSUB_TIMELINE_H
+#define LIBSUB_TIMELINE_H
+
+#include "sub_time.h"
+#include "interval_tree.h"
+#include <vector>
+
+namespace sub {
+
+/** @class Timeline
+ *  @brief An index of the times of some subtitles, for finding those which are on
+ *  screen at a time or during a period.
+ *
+ *  A Timeline can be made from any container of things with from and to Times, such
+ *  as Subtitles, RawSubtitles or FlatSubtitles.  Each is on screen from its from time
+ *  up to (but not including) its to time, and is referred to by its index in the
+ *  container.  Results are given in order of from time, and for equal from times in
+ *  the order of the container.
+ *
+ *  The subtitles are kept sorted by from time, as a balanced binary tree laid out in
+ *  that order where each node knows the latest to time of the subtitles below it.
+ *  Building the index takes O(n log n).  A query for k results takes O(log n) for
+ *  k = 0 and never more than O(k log n); it is usually close to O(log n + k).
+ */
+class Timeline
+{
+public:
+	Timeline () {}
+
+	template <class T>
+	explicit Timeline (T const & subtitles)
+	{
+		std::vector<Time> from;
+		std::vector<Time> to;
+		for (typename T::const_iterator i = subtitles.begin(); i != subtitles.end(); ++i) {
+			from.push_back (i->from);
+			to.push_back (i->to);
+		}
+		_tree.build (from, to);
+	}
+
+	void at (Time t, std::vector<size_t>& indices) const;
+	void during (Time from, Time to, std::vector<size_t>& indices) const;
+
+	/** @return number of subtitles */
+	size_t size () const {
+		return _tree.size ();
+	}
+
+	/** @return the tree of subtitle times, whose indices are those of the subtitles */
+	IntervalTree<Time> const & tree () const {
+		return _tree;
+	}
+
+	/** @class Cursor
+	 *  @brief Something to step through a Timeline in time order, finding which subtitles
+	 *  are on screen at each time more cheaply than by calling Timeline::at() each time.
+	 *
+	 *  Moving forward costs O(1) amortised plus the number of subtitles on screen;
+	 *  moving backwards uses Timeline::at().
+	 */
+	class Cursor
+	{
+	public:
+		explicit Cursor (Timeline const & timeline);
+
+		std::vector<size_t> const & at (Time t);
+
+	private:
+		Timeline const & _timeline;
+		IntervalTreeCursor<Time> _cursor;
+		/** indices of the subtitles that are on screen, to return from at() */
+		std::vector<size_t> _indices;
+	};
+
+private:
+	IntervalTree<Time> _tree;
+};
+
+}
+
+#endif
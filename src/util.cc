@@ -18,13 +18,10 @@
 */
 
 #include "util.h"
+#include "line_source.h"
 #include <string>
-#include <iostream>
-#include <cstdio>
 
 using std::string;
-using std::getline;
-using boost::optional;
 
 /** @param s A string.
  *  @return true if the string contains only space, newline or tab characters, or is empty.
@@ -41,48 +38,17 @@ sub::empty_or_white_space (string s)
 	return true;
 }
 
-optional<string>
-sub::get_line_string (string* s)
-{
-	if (s->length() == 0) {
-		return optional<string>();
-	}
-
-	size_t pos = s->find ("\n");
-	if (pos == string::npos) {
-		string const c = *s;
-		*s = "";
-		return c;
-	}
-
-	string const c = s->substr (0, pos);
-	s->erase (0, pos + 1);
-	return c;
-}
-
-optional<string>
-sub::get_line_file (FILE* f)
-{
-	char buffer[256];
-	char* r = fgets (buffer, sizeof (buffer), f);
-	if (r == 0) {
-		return optional<string> ();
-	}
-
-	return string (buffer);
-}
-
 void
-sub::remove_unicode_bom (optional<string>& line)
+sub::remove_unicode_bom (LineView& line)
 {
 	if (
-		line->length() >= 3 &&
-		static_cast<unsigned char> (line.get()[0]) == 0xef &&
-		static_cast<unsigned char> (line.get()[1]) == 0xbb &&
-		static_cast<unsigned char> (line.get()[2]) == 0xbf
+		line.size() >= 3 &&
+		static_cast<unsigned char> (line[0]) == 0xef &&
+		static_cast<unsigned char> (line[1]) == 0xbb &&
+		static_cast<unsigned char> (line[2]) == 0xbf
 		) {
 
 		/* Skip Unicode byte order mark */
-		line = line->substr (3);
+		line.remove_prefix (3);
 	}
 }
@@ -21,14 +21,13 @@
  *  @brief Utility methods.
  */
 
-#include <boost/optional.hpp>
 #include <string>
 
 namespace sub {
 
+class LineView;
+
 extern bool empty_or_white_space (std::string s);
-extern void remove_unicode_bom (boost::optional<std::string>& line);
-extern boost::optional<std::string> get_line_file (FILE* f);
-extern boost::optional<std::string> get_line_string (std::string* s);
+extern void remove_unicode_bom (LineView& line);
 
 }
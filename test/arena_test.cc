@@ -0,0 +1,74 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#include "arena.h"
+#include <boost/test/unit_test.hpp>
+#include <cstring>
+#include <list>
+#include <string>
+
+using std::list;
+using std::string;
+using sub::Arena;
+using sub::ArenaAllocator;
+
+BOOST_AUTO_TEST_CASE (arena_test)
+{
+	Arena arena (1024);
+
+	/* Small allocations come from one chunk, and are aligned */
+	for (int i = 0; i < 10; ++i) {
+		char* c = static_cast<char *> (arena.allocate (3, 1));
+		memset (c, 'x', 3);
+		void* p = arena.allocate (8, 8);
+		BOOST_CHECK_EQUAL (reinterpret_cast<size_t> (p) % 8, 0U);
+	}
+	BOOST_CHECK_EQUAL (arena.heap_allocations(), 1U);
+	BOOST_CHECK_EQUAL (arena.bytes(), 110U);
+
+	/* A big one gets a chunk of its own, and small ones carry on from the old chunk */
+	char* big = static_cast<char *> (arena.allocate (4096));
+	memset (big, 'y', 4096);
+	BOOST_CHECK_EQUAL (arena.heap_allocations(), 2U);
+	arena.allocate (16);
+	BOOST_CHECK_EQUAL (arena.heap_allocations(), 2U);
+
+	string const s = "Hello world";
+	char const * copy = arena.copy (s.data(), s.size());
+	BOOST_CHECK_EQUAL (string (copy, s.size()), s);
+
+	arena.clear ();
+	BOOST_CHECK_EQUAL (arena.bytes(), 0U);
+}
+
+/** Check that a standard container can use an Arena */
+BOOST_AUTO_TEST_CASE (arena_allocator_test)
+{
+	Arena arena;
+	{
+		list<string, ArenaAllocator<string> > strings ((ArenaAllocator<string> (&arena)));
+		for (int i = 0; i < 1000; ++i) {
+			strings.push_back ("A string");
+		}
+		BOOST_CHECK_EQUAL (strings.size(), 1000U);
+		BOOST_CHECK_EQUAL (strings.back(), "A string");
+	}
+	BOOST_CHECK (arena.heap_allocations() < 5);
+	BOOST_CHECK (arena.bytes() >= 1000 * sizeof (string));
+}
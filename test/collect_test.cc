@@ -0,0 +1,91 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#include "collect.h"
+#include "random_subtitles.h"
+#include <boost/lexical_cast.hpp>
+#include <boost/test/unit_test.hpp>
+#include <list>
+#include <vector>
+
+using std::list;
+using std::vector;
+using boost::lexical_cast;
+using sub::RawSubtitle;
+using sub::Subtitle;
+using sub::Time;
+using sub::Rational;
+
+/** @return n RawSubtitles in no particular order, with lots of them sharing from times.
+ *  @param rate Rate of their times.
+ */
+static list<RawSubtitle>
+make_raw (int n, int rate)
+{
+	list<RawSubtitle> raw;
+	Random random;
+	for (int i = 0; i < n; ++i) {
+		unsigned int const state = random.next ();
+		RawSubtitle r;
+		r.text = "Subtitle " + lexical_cast<std::string> (i);
+		if (state & 0x100) {
+			r.font = "Font " + lexical_cast<std::string> ((state >> 12) % 4);
+		}
+		r.italic = state & 0x200;
+		/* Negative times should sort properly too */
+		int const frame = int ((state >> 16) % 500) - 50;
+		r.from = Time::from_frames (frame, Rational (rate, 1));
+		r.to = Time::from_frames (frame + 10 + (state >> 20) % 2, Rational (rate, 1));
+		r.vertical_position.line = (state >> 24) % 3;
+		r.vertical_position.reference = sub::TOP_OF_SCREEN;
+		raw.push_back (r);
+	}
+	return raw;
+}
+
+/** What collect() did when it sorted the list itself and copied each RawSubtitle */
+static list<Subtitle>
+simple_collect (list<RawSubtitle> raw)
+{
+	raw.sort ();
+	list<Subtitle> out;
+	for (list<RawSubtitle>::const_iterator i = raw.begin(); i != raw.end(); ++i) {
+		sub::collect_add (out, *i);
+	}
+	return out;
+}
+
+/** Check that collect() gives the same result as the simple way of collecting, both
+ *  when its radix sort is used (for rates whose frames are whole numbers of ticks)
+ *  and when it is not.
+ */
+BOOST_AUTO_TEST_CASE (collect_sort_test)
+{
+	int const rates[] = { 25, 1000, 23 };
+	for (int i = 0; i < 3; ++i) {
+		for (int n = 10; n <= 10000; n *= 10) {
+			list<RawSubtitle> const raw = make_raw (n, rates[i]);
+			list<Subtitle> const reference = simple_collect (raw);
+			BOOST_CHECK (sub::collect<list<Subtitle> > (raw) == reference);
+			BOOST_CHECK (sub::collect<list<Subtitle> > (raw.begin(), raw.end()) == reference);
+			vector<Subtitle> const v = sub::collect<vector<Subtitle> > (raw);
+			BOOST_CHECK (list<Subtitle> (v.begin(), v.end()) == reference);
+		}
+	}
+}
@@ -0,0 +1,87 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#include "collector.h"
+#include "collect.h"
+#include "random_subtitles.h"
+#include <boost/lexical_cast.hpp>
+#include <boost/test/unit_test.hpp>
+#include <list>
+#include <vector>
+
+using std::list;
+using std::vector;
+using boost::lexical_cast;
+using sub::RawSubtitle;
+using sub::Subtitle;
+using sub::Time;
+using sub::Rational;
+
+/** Check that a Collector gives the same result as collect() for input which is
+ *  a little out of order, and that it does not hold on to more input than it must.
+ */
+BOOST_AUTO_TEST_CASE (collector_test)
+{
+	Rational const rate (25, 1);
+
+	/* Pairs of lines every 2s, each of which may arrive up to 12 frames late */
+	vector<RawSubtitle> raw;
+	Random random;
+	for (int i = 0; i < 2000; ++i) {
+		RawSubtitle r;
+		r.text = "Line " + lexical_cast<std::string> (i);
+		r.from = Time::from_frames ((i / 2) * 50, rate);
+		r.to = Time::from_frames ((i / 2) * 50 + 40, rate);
+		r.vertical_position.line = i % 2;
+		r.vertical_position.reference = sub::TOP_OF_SCREEN;
+		if (random.get (3) == 0) {
+			r.from.add (Time::from_frames (12, rate));
+		}
+		raw.push_back (r);
+	}
+
+	vector<RawSubtitle> input = raw;
+	for (size_t i = 0; i + 1 < input.size(); i += 3) {
+		std::swap (input[i], input[i + 1]);
+	}
+
+	sub::Collector collector (Time::from_frames (50 + 12, rate));
+	list<Subtitle> out;
+	size_t max_pending = 0;
+	for (vector<RawSubtitle>::const_iterator i = input.begin(); i != input.end(); ++i) {
+		collector.add (*i);
+		max_pending = std::max (max_pending, collector.pending ());
+		Subtitle s;
+		while (collector.get (s)) {
+			out.push_back (s);
+		}
+	}
+
+	BOOST_CHECK (max_pending < 10);
+	BOOST_CHECK (out.size() > 1000);
+
+	collector.finish ();
+	Subtitle s;
+	while (collector.get (s)) {
+		out.push_back (s);
+	}
+
+	BOOST_CHECK_EQUAL (collector.pending(), 0U);
+	BOOST_CHECK (out == sub::collect<list<Subtitle> > (input.begin(), input.end()));
+}
@@ -0,0 +1,84 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#include "flat_document.h"
+#include "collect.h"
+#include "subrip_reader.h"
+#include <boost/test/unit_test.hpp>
+#include <list>
+#include <vector>
+
+using std::list;
+using std::string;
+using std::vector;
+using sub::Subtitle;
+
+static string const srt =
+	"1\n"
+	"00:00:01,000 --> 00:00:02,000\n"
+	"Hello <i>world</i>\n"
+	"Second line\n"
+	"\n"
+	"2\n"
+	"00:00:03,000 --> 00:00:04,500\n"
+	"<b>Bold</b> and <font color=\"#ff0000\">red</font>\n"
+	"\n"
+	"3\n"
+	"00:00:02,500 --> 00:00:03,000\n"
+	"Out of order\n";
+
+/** Check that converting to and from a FlatDocument gives back what we started with,
+ *  and that collect_flat() gives the same as collect().
+ */
+BOOST_AUTO_TEST_CASE (flat_document_test)
+{
+	sub::SubripReader reader (srt.data(), srt.size());
+	list<Subtitle> subs = sub::collect<list<Subtitle> > (reader.subtitles ());
+	BOOST_REQUIRE_EQUAL (subs.size(), 3U);
+
+	sub::FlatDocument const collected = sub::collect_flat (reader.subtitles ());
+	BOOST_CHECK (collected.as<list<Subtitle> > () == subs);
+
+	/* Give most blocks a font, to check that they survive the arena */
+	int n = 0;
+	for (list<Subtitle>::iterator i = subs.begin(); i != subs.end(); ++i) {
+		for (list<sub::Line>::iterator j = i->lines.begin(); j != i->lines.end(); ++j) {
+			for (list<sub::Block>::iterator k = j->blocks.begin(); k != j->blocks.end(); ++k) {
+				if (n % 3 != 2) {
+					k->font = n < 4 ? "Arial" : "Helvetica";
+				}
+				++n;
+			}
+		}
+	}
+
+	sub::FlatDocument const doc (subs);
+	BOOST_CHECK_EQUAL (doc.subtitles.size(), 3U);
+	BOOST_CHECK_EQUAL (doc.lines.size(), 4U);
+	BOOST_CHECK (doc.as<list<Subtitle> > () == subs);
+
+	vector<Subtitle> const v = doc.as<vector<Subtitle> > ();
+	BOOST_CHECK (list<Subtitle> (v.begin(), v.end()) == subs);
+
+	/* The first block of the first line */
+	sub::FlatBlock const & b = doc.blocks[doc.lines[doc.subtitles[0].first_line].first_block];
+	BOOST_CHECK_EQUAL (doc.text_string (b), "Hello ");
+	BOOST_CHECK_EQUAL (string (b.text, b.text_size), "Hello ");
+	BOOST_CHECK (doc.style(b).font == string ("Arial"));
+}
@@ -19,10 +19,16 @@
 
 #include <boost/test/unit_test.hpp>
 #include "iso6937.h"
+#include "iso6937_tables.h"
+#include "random.h"
 #include <boost/locale.hpp>
+#include <algorithm>
 #include <iostream>
+#include <string>
 
 using std::cout;
+using std::string;
+using std::wstring;
 using boost::locale::conv::utf_to_utf;
 
 BOOST_AUTO_TEST_CASE (iso6937_to_utf16_test)
@@ -43,3 +49,93 @@ BOOST_AUTO_TEST_CASE (utf16_to_iso6937_test)
 	BOOST_CHECK_EQUAL (sub::utf16_to_iso6937 (utf_to_utf<wchar_t> ("Pass\nnewlines\nthrough")), "Pass\nnewlines\nthrough");
 	BOOST_CHECK_EQUAL (sub::utf16_to_iso6937 (utf_to_utf<wchar_t> ("Ignore prime′s and just use quote's")), "Ignore prime's and just use quote's");
 }
+
+/** @return the encoding of c found by searching the decoding tables in the order
+ *  that utf16_to_iso6937 used to, which was bytes 0x80-0xff before 0x00-0x7f.
+ */
+static string
+search_tables (wchar_t c)
+{
+	for (int i = 0; i < 256; ++i) {
+		int const j = (i + 128) % 256;
+		if (sub::iso6937::main[j] == c) {
+			return string (1, j);
+		}
+	}
+
+	for (int i = sub::iso6937::first_diacritical; i <= sub::iso6937::last_diacritical; ++i) {
+		for (int j = 0; j < 256; ++j) {
+			if (sub::iso6937::diacriticals[i - sub::iso6937::first_diacritical][j] == c) {
+				return string (1, i) + char (j);
+			}
+		}
+	}
+
+	return "";
+}
+
+/** Check utf16_to_iso6937 against a search of the tables for every code in the BMP */
+BOOST_AUTO_TEST_CASE (utf16_to_iso6937_all_test)
+{
+	int differences = 0;
+	for (wchar_t c = 1; c < 0x10000; ++c) {
+		string expected = search_tables (c);
+		if (c == 0x201e) {
+			expected = "\xAA";
+		} else if (c == 0x2013 || c == 0x2014) {
+			expected = "\xD0";
+		} else if (c == 0x2010 || c == 0x2011 || c == 0x2012) {
+			expected = "-";
+		} else if (c == 0x2032) {
+			expected = "'";
+		}
+
+		if (sub::utf16_to_iso6937 (wstring (1, c)) != expected) {
+			++differences;
+		}
+	}
+
+	BOOST_CHECK_EQUAL (differences, 0);
+	BOOST_CHECK_EQUAL (sub::utf16_to_iso6937 (L"$"), "\xA4");
+	BOOST_CHECK_EQUAL (sub::utf16_to_iso6937 (utf_to_utf<wchar_t> ("– and — are “bars”")), "\xD0 and \xD0 are \xAA""bars\xBA");
+}
+
+/** Check iso6937_to_utf8 against iso6937_to_utf16 on random text, with runs of ASCII
+ *  of various lengths starting at various offsets.
+ */
+BOOST_AUTO_TEST_CASE (iso6937_to_utf8_test)
+{
+	BOOST_CHECK_EQUAL (sub::iso6937_to_utf8 ("", 0), "");
+	BOOST_CHECK_EQUAL (sub::iso6937_to_utf8 ("M\xC8otorhead", 10), "Mötorhead");
+	/* Zero bytes are skipped, not the end of the string */
+	BOOST_CHECK_EQUAL (sub::iso6937_to_utf8 ("Mot\0orhead", 10), "Motorhead");
+
+	Random random;
+	int differences = 0;
+	for (int i = 0; i < 2000; ++i) {
+		string in;
+		int const length = i % 200;
+		for (int j = 0; j < length; ++j) {
+			unsigned int const state = random.next ();
+			int const r = (state >> 8) % 256;
+			if (r < 200) {
+				in += char (0x20 + r % 0x5f);
+			} else {
+				/* Anything but zero */
+				in += char (1 + (state >> 16) % 255);
+			}
+		}
+
+		/* iso6937_to_utf16 stops at a zero, and gives zeros where iso6937_to_utf8 gives nothing */
+		string expected = utf_to_utf<char> (sub::iso6937_to_utf16 (in));
+		expected.erase (std::remove (expected.begin(), expected.end(), '\0'), expected.end());
+		/* Leave some text already there to check that we append to it */
+		string out = "x";
+		sub::iso6937_to_utf8 (in.data(), in.size(), out);
+		if (out != "x" + expected) {
+			++differences;
+		}
+	}
+
+	BOOST_CHECK_EQUAL (differences, 0);
+}
@@ -0,0 +1,97 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#include "line_source.h"
+#include "subrip_reader.h"
+#include <boost/test/unit_test.hpp>
+#include <sstream>
+#include <vector>
+
+using std::string;
+using std::vector;
+using std::stringstream;
+
+/** Lines which are long, or which are split across refills of a StreamLineSource's buffer */
+static string
+make_lines (vector<string>& lines)
+{
+	string all;
+	for (int i = 0; i < 4000; ++i) {
+		lines.push_back (string (i * 37 % 1000, 'a' + (i % 26)));
+		all += lines.back() + "\n";
+	}
+	/* A huge line which will not fit in the initial buffer */
+	lines.push_back (string (200000, 'x'));
+	all += lines.back() + "\n";
+	/* and a last line with no terminator */
+	lines.push_back ("The end");
+	all += lines.back();
+	return all;
+}
+
+BOOST_AUTO_TEST_CASE (buffer_line_source_test)
+{
+	vector<string> lines;
+	string const all = make_lines (lines);
+
+	sub::BufferLineSource source (all.data(), all.size());
+	sub::LineView line;
+	for (size_t i = 0; i < lines.size(); ++i) {
+		BOOST_REQUIRE (source.get (line));
+		BOOST_CHECK (line.to_string() == lines[i]);
+	}
+	BOOST_CHECK (!source.get (line));
+}
+
+BOOST_AUTO_TEST_CASE (stream_line_source_test)
+{
+	vector<string> lines;
+	stringstream s (make_lines (lines));
+
+	sub::StreamLineSource source (s);
+	sub::LineView line;
+	for (size_t i = 0; i < lines.size(); ++i) {
+		BOOST_REQUIRE (source.get (line));
+		BOOST_CHECK (line.to_string() == lines[i]);
+	}
+	BOOST_CHECK (!source.get (line));
+}
+
+BOOST_AUTO_TEST_CASE (line_view_test)
+{
+	string const s = " \t[Events]\r\n";
+	sub::LineView v (s.data(), s.size());
+	v.trim ();
+	BOOST_CHECK (v == "[Events]");
+	BOOST_CHECK (v.starts_with ("["));
+	BOOST_CHECK (!v.starts_with ("[Events]!"));
+	v.remove_prefix (1);
+	v.trim_right ("]");
+	BOOST_CHECK_EQUAL (v.to_string(), "Events");
+}
+
+/** Check that SubripReader copes with text lines longer than the old 256-byte limit */
+BOOST_AUTO_TEST_CASE (subrip_reader_long_line_test)
+{
+	string const text (1000, 'z');
+	string const srt = "1\n00:00:01,000 --> 00:00:02,000\n" + text + "\n";
+	sub::SubripReader reader (srt.data(), srt.size());
+	BOOST_REQUIRE_EQUAL (reader.subtitles().size(), 1U);
+	BOOST_CHECK_EQUAL (reader.subtitles().front().text, text);
+}
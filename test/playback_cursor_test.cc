@@ -0,0 +1,144 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#include "playback_cursor.h"
+#include "timeline.h"
+#include "raw_subtitle.h"
+#include "random_subtitles.h"
+#include <boost/test/unit_test.hpp>
+#include <set>
+#include <vector>
+
+using std::set;
+using std::vector;
+using sub::RawSubtitle;
+using sub::Time;
+using sub::Rational;
+using sub::Timeline;
+using sub::PlaybackCursor;
+using sub::PlaybackEvent;
+
+/** @return Subtitles timed in milliseconds, so that they are not on frame boundaries
+ *  at 24fps, in no particular order and overlapping each other a lot.
+ */
+static vector<RawSubtitle>
+make_millisecond_subtitles ()
+{
+	return make_random_subtitles (7, 2000, Rational (1000, 1), 400000, 500, 20000);
+}
+
+/** True for subtitles which are on screen in a frame, as a PlaybackCursor sees it */
+class OnScreenInFrame
+{
+public:
+	OnScreenInFrame (PlaybackCursor const & cursor, int64_t frame)
+		: _cursor (cursor)
+		, _frame (frame)
+	{}
+
+	bool operator() (RawSubtitle const & s) const {
+		return _cursor.frame (s.from) <= _frame && _frame < _cursor.frame (s.to);
+	}
+
+private:
+	PlaybackCursor const & _cursor;
+	int64_t _frame;
+};
+
+/** Apply events to a set of what is on screen.
+ *  @return false if the events were inconsistent with on_screen.
+ */
+static bool
+apply (vector<PlaybackEvent> const & events, set<size_t>& on_screen)
+{
+	bool entered = false;
+	for (vector<PlaybackEvent>::const_iterator i = events.begin(); i != events.end(); ++i) {
+		if (i->type == PlaybackEvent::ENTER) {
+			if (!on_screen.insert(i->index).second) {
+				return false;
+			}
+			entered = true;
+		} else {
+			if (entered || on_screen.erase(i->index) != 1) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/** Check that PlaybackCursor's events and on_screen() agree with a brute-force search
+ *  when playing, jumping forwards and jumping backwards.
+ */
+BOOST_AUTO_TEST_CASE (playback_cursor_test)
+{
+	vector<RawSubtitle> const subs = make_millisecond_subtitles ();
+	Timeline const timeline (subs);
+	PlaybackCursor cursor (timeline, Rational (24, 1));
+
+	set<size_t> on_screen;
+	int differences = 0;
+	for (int64_t f = -2; f < 10000; ++f) {
+		if (!apply (cursor.move (f), on_screen)) {
+			++differences;
+		}
+		vector<size_t> const expected = brute_force (subs, OnScreenInFrame (cursor, f));
+		if (cursor.on_screen() != expected || on_screen != set<size_t> (expected.begin(), expected.end())) {
+			++differences;
+		}
+	}
+
+	int const jumps[] = { 3, 1000, 1001, 9000, 200, 200, 5000, 5070, 5500, 0, 10000, -1 };
+	for (size_t i = 0; i < sizeof (jumps) / sizeof (jumps[0]); ++i) {
+		if (!apply (cursor.move (jumps[i]), on_screen)) {
+			++differences;
+		}
+		vector<size_t> const expected = brute_force (subs, OnScreenInFrame (cursor, jumps[i]));
+		if (cursor.on_screen() != expected || on_screen != set<size_t> (expected.begin(), expected.end())) {
+			++differences;
+		}
+	}
+
+	BOOST_CHECK_EQUAL (differences, 0);
+	BOOST_CHECK (on_screen.empty ());
+}
+
+/** Check which frames a subtitle which does not start or end on a frame boundary is on */
+BOOST_AUTO_TEST_CASE (playback_cursor_frame_test)
+{
+	vector<RawSubtitle> subs (1);
+	/* 1.02s is 24.48 frames at 24fps, so this starts in frame 24 */
+	subs[0].from = Time::from_hms (0, 0, 1, 20);
+	/* 2.03s is 48.72 frames, so this ends in frame 49 */
+	subs[0].to = Time::from_hms (0, 0, 2, 30);
+	Timeline const timeline (subs);
+	PlaybackCursor cursor (timeline, Rational (24, 1));
+
+	BOOST_CHECK (cursor.move(23).empty());
+	vector<PlaybackEvent> events = cursor.move (Time::from_frames (24, Rational (24, 1)));
+	BOOST_REQUIRE_EQUAL (events.size(), 1U);
+	BOOST_CHECK_EQUAL (events[0].type, PlaybackEvent::ENTER);
+	BOOST_CHECK_EQUAL (events[0].index, 0U);
+	BOOST_CHECK (cursor.move(48).empty());
+	BOOST_CHECK_EQUAL (cursor.on_screen().size(), 1U);
+	events = cursor.move (49);
+	BOOST_REQUIRE_EQUAL (events.size(), 1U);
+	BOOST_CHECK_EQUAL (events[0].type, PlaybackEvent::EXIT);
+	BOOST_CHECK (cursor.on_screen().empty());
+}
@@ -0,0 +1,50 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  test/random.h
+ *  @brief Random class.
+ */
+
+#ifndef LIBSUB_TEST_RANDOM_H
+#define LIBSUB_TEST_RANDOM_H
+
+/** A small, repeatable pseudo-random number generator */
+class Random
+{
+public:
+	explicit Random (unsigned int seed = 1)
+		: _state (seed)
+	{}
+
+	/** @return next number; the higher bits are more random than the lower ones */
+	unsigned int next () {
+		_state = _state * 1103515245 + 12345;
+		return _state;
+	}
+
+	/** @return number in [0, n) */
+	int get (int n) {
+		return (next() >> 16) % n;
+	}
+
+private:
+	unsigned int _state;
+};
+
+#endif
@@ -0,0 +1,50 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#include "random_subtitles.h"
+
+using std::vector;
+using sub::RawSubtitle;
+using sub::Time;
+using sub::Rational;
+
+/** @return Subtitles in no particular order which overlap each other a lot.
+ *  @param seed Seed for the random numbers.
+ *  @param count Number of subtitles.
+ *  @param rate Rate of the subtitles' times.
+ *  @param span Each subtitle starts at some frame in [0, span).
+ *  @param short_length Lengths of about half of the subtitles are in [1, short_length] frames.
+ *  @param long_length Lengths of the others are in [1, long_length] frames.
+ */
+vector<RawSubtitle>
+make_random_subtitles (unsigned int seed, int count, Rational rate, int span, int short_length, int long_length)
+{
+	Random random (seed);
+	vector<RawSubtitle> subs;
+	for (int i = 0; i < count; ++i) {
+		int const from = (random.next() >> 8) % span;
+		unsigned int const r = random.next ();
+		int const length = 1 + (r >> 8) % ((r & 0x10000) ? short_length : long_length);
+		RawSubtitle s;
+		s.from = Time::from_frames (from, rate);
+		s.to = Time::from_frames (from + length, rate);
+		subs.push_back (s);
+	}
+	return subs;
+}
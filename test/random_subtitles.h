@@ -0,0 +1,104 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  test/random_subtitles.h
+ *  @brief Repeatable pseudo-random test data, and a brute-force search of it to check
+ *  cleverer searches against.
+ */
+
+#ifndef LIBSUB_TEST_RANDOM_SUBTITLES_H
+#define LIBSUB_TEST_RANDOM_SUBTITLES_H
+
+#include "random.h"
+#include "raw_subtitle.h"
+#include <algorithm>
+#include <vector>
+
+extern std::vector<sub::RawSubtitle> make_random_subtitles (
+	unsigned int seed, int count, sub::Rational rate, int span, int short_length, int long_length
+	);
+
+/** Comparator to sort indices into some subtitles by from time */
+class SubtitleFromLess
+{
+public:
+	explicit SubtitleFromLess (std::vector<sub::RawSubtitle> const & subs)
+		: _subs (subs)
+	{}
+
+	bool operator() (size_t a, size_t b) const {
+		return _subs[a].from < _subs[b].from;
+	}
+
+private:
+	std::vector<sub::RawSubtitle> const & _subs;
+};
+
+/** @param on_screen Function object which takes a RawSubtitle and returns true if it is on screen.
+ *  @return indices of subs which are on screen, in order of from time and then of index.
+ */
+template <class P>
+std::vector<size_t>
+brute_force (std::vector<sub::RawSubtitle> const & subs, P on_screen)
+{
+	std::vector<size_t> out;
+	for (size_t i = 0; i < subs.size(); ++i) {
+		if (on_screen (subs[i])) {
+			out.push_back (i);
+		}
+	}
+	std::stable_sort (out.begin(), out.end(), SubtitleFromLess (subs));
+	return out;
+}
+
+/** True for subtitles which are on screen at a time */
+class OnScreenAt
+{
+public:
+	explicit OnScreenAt (sub::Time t)
+		: _t (t)
+	{}
+
+	bool operator() (sub::RawSubtitle const & s) const {
+		return !(_t < s.from) && _t < s.to;
+	}
+
+private:
+	sub::Time _t;
+};
+
+/** True for subtitles which are on screen at some time in [from, to) */
+class OnScreenDuring
+{
+public:
+	OnScreenDuring (sub::Time from, sub::Time to)
+		: _from (from)
+		, _to (to)
+	{}
+
+	bool operator() (sub::RawSubtitle const & s) const {
+		return s.from < _to && _from < s.to;
+	}
+
+private:
+	sub::Time _from;
+	sub::Time _to;
+};
+
+#endif
@@ -0,0 +1,108 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#include "retime.h"
+#include "raw_subtitle.h"
+#include "random_subtitles.h"
+#include <boost/test/unit_test.hpp>
+#include <list>
+#include <vector>
+
+using std::list;
+using std::vector;
+using sub::Time;
+using sub::Rational;
+using sub::Retime;
+using sub::RawSubtitle;
+
+/** @return n times at various rates, some of which cannot be held as ticks */
+static vector<Time>
+make_times (int n)
+{
+	static int const rates[] = { 24, 25, 30, 1000, 23 };
+	vector<Time> times;
+	Random random;
+	for (int i = 0; i < n; ++i) {
+		unsigned int const state = random.next ();
+		int const rate = rates[(state >> 16) % 5];
+		int const frames = (state >> 8) % (10 * 3600 * rate);
+		times.push_back (Time::from_frames (frames, Rational (rate, 1)));
+	}
+	return times;
+}
+
+static void
+check_retime (Retime const & r, int threads)
+{
+	vector<Time> times = make_times (200000);
+	vector<Time> ref = times;
+	for (vector<Time>::iterator i = ref.begin(); i != ref.end(); ++i) {
+		i->retime (r.scale, r.offset, r.rate);
+	}
+
+	sub::retime (times, r, threads);
+
+	int differences = 0;
+	for (size_t i = 0; i < times.size(); ++i) {
+		if (!(times[i] == ref[i]) || times[i].frames_at (r.rate) != ref[i].frames_at (r.rate)) {
+			++differences;
+		}
+	}
+	BOOST_CHECK_EQUAL (differences, 0);
+}
+
+/** Check that retiming in bulk gives the same answers as Time::retime */
+BOOST_AUTO_TEST_CASE (retime_batch_test)
+{
+	for (int threads = 1; threads <= 4; threads += 3) {
+		/* Simple offset */
+		check_retime (Retime (Rational (1, 1), Time::from_hms (0, 0, 10, 0), Rational (25, 1)), threads);
+		/* Negative offset */
+		check_retime (Retime (Rational (1, 1), Time::from_frames (-37, Rational (24, 1)), Rational (24, 1)), threads);
+		/* PAL speed-up */
+		check_retime (Retime (Rational (24, 25), Time::from_frames (0, Rational (25, 1)), Rational (25, 1)), threads);
+		/* 25fps to 23.976fps, rounded to 24fps frames as the output rate must be an integer */
+		check_retime (Retime (Rational (25 * 1001, 24000), Time::from_frames (3, Rational (25, 1)), Rational (24, 1)), threads);
+		/* Offset which is not a whole number of ticks */
+		check_retime (Retime (Rational (2, 1), Time::from_frames (5, Rational (23, 1)), Rational (30, 1)), threads);
+		/* Scale and rate large enough that the bulk arithmetic would overflow */
+		check_retime (Retime (Rational (1000003, 1000000), Time::from_frames (3, Rational (25, 1)), Rational (10007, 1)), threads);
+	}
+}
+
+BOOST_AUTO_TEST_CASE (retime_track_test)
+{
+	list<RawSubtitle> subs;
+	RawSubtitle a;
+	a.from = Time::from_hms (0, 0, 25, 0);
+	a.to = Time::from_hms (0, 0, 50, 0);
+	subs.push_back (a);
+	a.from = Time::from_hmsf (0, 1, 0, 12, Rational (25, 1));
+	a.to = Time::from_hmsf (0, 1, 1, 0, Rational (25, 1));
+	subs.push_back (a);
+
+	list<RawSubtitle> const out = sub::retime (subs, Retime (Rational (24, 25), Time::from_hms (0, 0, 1, 0), Rational (24, 1)));
+	BOOST_REQUIRE_EQUAL (out.size(), 2U);
+	BOOST_CHECK_EQUAL (out.front().from, Time::from_hmsf (0, 0, 25, 0, Rational (24, 1)));
+	BOOST_CHECK_EQUAL (out.front().to, Time::from_hmsf (0, 0, 49, 0, Rational (24, 1)));
+	/* 60.48s * 24/25 + 1 = 59.0608s, which is 59s + 1.4592 frames */
+	BOOST_CHECK_EQUAL (out.back().from, Time::from_hmsf (0, 0, 59, 1, Rational (24, 1)));
+	/* 61s * 24/25 + 1 = 59.56s, which is 59s + 13.44 frames */
+	BOOST_CHECK_EQUAL (out.back().to, Time::from_hmsf (0, 0, 59, 13, Rational (24, 1)));
+}
@@ -0,0 +1,90 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#include "stl_binary_gsi.h"
+#include "stl_binary_reader.h"
+#include "stl_binary_writer.h"
+#include "subtitle.h"
+#include "exceptions.h"
+#include <boost/test/unit_test.hpp>
+#include <boost/algorithm/string.hpp>
+#include <fstream>
+
+using std::map;
+using std::string;
+
+/** Check that STLBinaryGSI reads the same information as STLBinaryReader */
+BOOST_AUTO_TEST_CASE (stl_binary_gsi_test)
+{
+	boost::filesystem::path const file = "build/test/stl_binary_gsi_test.stl";
+
+	{
+		sub::STLBinaryWriter writer (
+			file, 25, sub::LANGUAGE_FRENCH,
+			"Programme", "Episode", "Programme traduit", "Episode traduit",
+			"Translator", "translator@example.com", "190101", "190102", 3, "FRA", "Publisher", "Editor", "editor@example.com"
+			);
+
+		for (int i = 0; i < 10; ++i) {
+			sub::Subtitle s;
+			s.from = sub::Time::from_hms (0, 0, i * 2, 0);
+			s.to = sub::Time::from_hms (0, 0, i * 2 + 1, 0);
+			sub::Line l;
+			l.vertical_position.line = 0;
+			l.vertical_position.lines = 23;
+			l.vertical_position.reference = sub::TOP_OF_SCREEN;
+			sub::Block b;
+			b.text = "Bonjour";
+			l.blocks.push_back (b);
+			s.lines.push_back (l);
+			writer.write (s);
+		}
+	}
+
+	sub::STLBinaryGSI gsi (file);
+
+	std::ifstream in (file.string().c_str(), std::ios::binary);
+	sub::STLBinaryReader reader (in);
+
+	BOOST_CHECK_EQUAL (gsi.frame_rate, 25);
+	BOOST_CHECK_EQUAL (gsi.language, sub::LANGUAGE_FRENCH);
+	/* Text fields are read with the spaces which pad them in the file */
+	BOOST_CHECK_EQUAL (gsi.original_programme_title.length(), 32);
+	BOOST_CHECK_EQUAL (boost::trim_right_copy (gsi.original_programme_title), "Programme");
+	BOOST_CHECK_EQUAL (boost::trim_right_copy (gsi.translated_episode_title), "Episode traduit");
+	BOOST_CHECK_EQUAL (boost::trim_right_copy (gsi.editor_contact_details), "editor@example.com");
+	BOOST_CHECK_EQUAL (gsi.number_of_subtitles, 10);
+	BOOST_CHECK_EQUAL (gsi.tti_blocks, reader.tti_blocks);
+
+	map<string, string> const probed = gsi.metadata ();
+	map<string, string> const read = reader.metadata ();
+	BOOST_CHECK (probed == read);
+}
+
+/** Check that STLBinaryGSI complains about a file which is too short */
+BOOST_AUTO_TEST_CASE (stl_binary_gsi_short_test)
+{
+	boost::filesystem::path const file = "build/test/stl_binary_gsi_short_test.stl";
+	{
+		std::ofstream out (file.string().c_str(), std::ios::binary);
+		out << string (512, ' ');
+	}
+
+	BOOST_CHECK_THROW (sub::STLBinaryGSI gsi (file), sub::STLError);
+}
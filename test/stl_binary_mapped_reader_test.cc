@@ -0,0 +1,119 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#include "stl_binary_mapped_reader.h"
+#include "stl_binary_reader.h"
+#include "stl_binary_writer.h"
+#include "subtitle.h"
+#include <boost/test/unit_test.hpp>
+#include <boost/lexical_cast.hpp>
+#include <fstream>
+#include <list>
+
+using std::list;
+using std::string;
+using sub::Time;
+using sub::Rational;
+using sub::RawSubtitle;
+
+static Time
+frame (int f)
+{
+	return Time::from_frames (f, Rational (25, 1));
+}
+
+/** Write 1000 subtitles, some long enough to need extension blocks and some at the same
+ *  time as the one before, and check that STLBinaryMappedReader reads what STLBinaryReader does.
+ */
+BOOST_AUTO_TEST_CASE (stl_binary_mapped_reader_test)
+{
+	boost::filesystem::path const file = "build/test/stl_binary_mapped_reader_test.stl";
+
+	{
+		sub::STLBinaryWriter writer (
+			file, 25, sub::LANGUAGE_ENGLISH,
+			"", "", "", "", "", "", "190101", "190101", 0, "GBR", "", "", ""
+			);
+
+		for (int i = 0; i < 1000; ++i) {
+			sub::Subtitle s;
+			s.from = frame ((i - i % 3) * 30);
+			s.to = frame ((i - i % 3) * 30 + 20);
+			sub::Line l;
+			l.vertical_position.line = i % 10;
+			l.vertical_position.lines = 23;
+			l.vertical_position.reference = sub::TOP_OF_SCREEN;
+			sub::Block b;
+			b.text = "Subtitle " + boost::lexical_cast<string> (i) + string ((i % 7) * 30, 'x');
+			b.italic = i % 2;
+			l.blocks.push_back (b);
+			s.lines.push_back (l);
+			writer.write (s);
+		}
+	}
+
+	std::ifstream in (file.string().c_str(), std::ios::binary);
+	sub::STLBinaryReader reader (in);
+	sub::STLBinaryMappedReader mapped (file);
+
+	BOOST_CHECK_EQUAL (mapped.gsi().frame_rate, 25);
+	BOOST_CHECK_EQUAL (mapped.gsi().maximum_rows, reader.maximum_rows);
+	BOOST_CHECK_EQUAL (mapped.tti_blocks(), size_t (reader.tti_blocks));
+	BOOST_CHECK (mapped.tti_blocks() > 1000);
+
+	list<RawSubtitle> subs;
+	size_t n = 0;
+	while (n < mapped.tti_blocks ()) {
+		n = mapped.subtitles (n, subs);
+	}
+
+	list<RawSubtitle> const expected = reader.subtitles ();
+	BOOST_REQUIRE_EQUAL (subs.size(), expected.size());
+	int differences = 0;
+	list<RawSubtitle>::const_iterator i = subs.begin ();
+	list<RawSubtitle>::const_iterator j = expected.begin ();
+	for (; i != subs.end(); ++i, ++j) {
+		if (i->text != j->text || i->from != j->from || i->to != j->to || i->italic != j->italic || !(i->vertical_position == j->vertical_position)) {
+			++differences;
+		}
+	}
+	BOOST_CHECK_EQUAL (differences, 0);
+
+	/* Check find() against a search from the start */
+	differences = 0;
+	for (int f = -1; f < 30100; f += 7) {
+		size_t k = 0;
+		while (k < mapped.tti_blocks() && mapped.tti(k).time_code_in(25) < frame (std::max (f, 0))) {
+			++k;
+		}
+		if (mapped.find (frame (std::max (f, 0))) != k) {
+			++differences;
+		}
+	}
+	BOOST_CHECK_EQUAL (differences, 0);
+
+	/* The last subtitle, 999, is the only one at frame 29970; it is italic, so the text
+	   comes after an empty piece from before the italic code.
+	*/
+	list<RawSubtitle> last;
+	mapped.subtitles (mapped.find (frame (29970)), last);
+	BOOST_REQUIRE (!last.empty ());
+	BOOST_CHECK_EQUAL (last.back().text, "Subtitle 999" + string (999 % 7 * 30, 'x'));
+	BOOST_CHECK_EQUAL (mapped.find (frame (29971)), mapped.tti_blocks ());
+}
@@ -0,0 +1,79 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#include "stl_binary_tables.h"
+#include "exceptions.h"
+#include <boost/test/unit_test.hpp>
+
+using std::string;
+
+/** Check that every Language survives a trip to and from its file code and its description */
+BOOST_AUTO_TEST_CASE (stl_binary_tables_language_test)
+{
+	for (int i = sub::LANGUAGE_UNKNOWN; i <= sub::LANGUAGE_ZULU; ++i) {
+		sub::Language const l = static_cast<sub::Language> (i);
+		string const file = sub::STLBinaryTables::language_enum_to_file (l);
+		BOOST_CHECK_EQUAL (file.length(), 2U);
+		BOOST_CHECK_EQUAL (sub::STLBinaryTables::language_file_to_enum (file), l);
+
+		boost::optional<sub::Language> d = sub::STLBinaryTables::language_description_to_enum (
+			sub::STLBinaryTables::language_enum_to_description (l)
+			);
+		BOOST_REQUIRE (d);
+		BOOST_CHECK_EQUAL (d.get(), l);
+	}
+
+	BOOST_CHECK_EQUAL (sub::STLBinaryTables::language_enum_to_file (sub::LANGUAGE_FRENCH), "0F");
+	BOOST_CHECK_EQUAL (sub::STLBinaryTables::language_file_to_enum ("45"), sub::LANGUAGE_ZULU);
+	BOOST_CHECK_EQUAL (sub::STLBinaryTables::language_enum_to_description (sub::LANGUAGE_SERBO_CROAT), "Serbo Croat");
+
+	BOOST_CHECK_THROW (sub::STLBinaryTables::language_file_to_enum ("2C"), sub::STLError);
+	BOOST_CHECK_THROW (sub::STLBinaryTables::language_file_to_enum ("80"), sub::STLError);
+	BOOST_CHECK_THROW (sub::STLBinaryTables::language_file_to_enum ("0f"), sub::STLError);
+	BOOST_CHECK_THROW (sub::STLBinaryTables::language_file_to_enum ("0"), sub::STLError);
+	BOOST_CHECK (!sub::STLBinaryTables::language_description_to_enum ("Klingon"));
+}
+
+/** Check the tables for the other parameters */
+BOOST_AUTO_TEST_CASE (stl_binary_tables_test)
+{
+	BOOST_CHECK_EQUAL (sub::STLBinaryTables::display_standard_file_to_enum (" "), sub::DISPLAY_STANDARD_UNDEFINED);
+	BOOST_CHECK_EQUAL (sub::STLBinaryTables::display_standard_file_to_enum ("2"), sub::DISPLAY_STANDARD_LEVEL_2_TELETEXT);
+	BOOST_CHECK_EQUAL (sub::STLBinaryTables::display_standard_enum_to_description (sub::DISPLAY_STANDARD_LEVEL_1_TELETEXT), "Level 1 teletext");
+	BOOST_CHECK_THROW (sub::STLBinaryTables::display_standard_file_to_enum ("3"), sub::STLError);
+
+	BOOST_CHECK_EQUAL (sub::STLBinaryTables::language_group_file_to_enum ("03"), sub::LANGUAGE_GROUP_LATIN_GREEK);
+	BOOST_CHECK_EQUAL (sub::STLBinaryTables::language_group_enum_to_description (sub::LANGUAGE_GROUP_LATIN_CYRILLIC), "Latin/Cyrillic");
+	BOOST_CHECK_THROW (sub::STLBinaryTables::language_group_file_to_enum ("05"), sub::STLError);
+
+	BOOST_CHECK_EQUAL (sub::STLBinaryTables::timecode_status_file_to_enum ("1"), sub::TIMECODE_STATUS_INTENDED_FOR_USE);
+	BOOST_CHECK_EQUAL (sub::STLBinaryTables::timecode_status_enum_to_description (sub::TIMECODE_STATUS_NOT_INTENDED_FOR_USE), "Not intended for use");
+
+	BOOST_CHECK_EQUAL (sub::STLBinaryTables::cumulative_status_file_to_enum (3), sub::CUMULATIVE_STATUS_LAST);
+	BOOST_CHECK_EQUAL (sub::STLBinaryTables::cumulative_status_enum_to_file (sub::CUMULATIVE_STATUS_NOT_CUMULATIVE), 0);
+	BOOST_CHECK_THROW (sub::STLBinaryTables::cumulative_status_file_to_enum (4), sub::STLError);
+
+	BOOST_CHECK_EQUAL (sub::STLBinaryTables::justification_file_to_enum (2), sub::JUSTIFICATION_CENTRE);
+	BOOST_CHECK_EQUAL (sub::STLBinaryTables::justification_enum_to_file (sub::JUSTIFICATION_RIGHT), 3);
+	BOOST_CHECK_EQUAL (sub::STLBinaryTables::justification_enum_to_description (sub::JUSTIFICATION_LEFT), "Left justification");
+
+	BOOST_CHECK_EQUAL (sub::STLBinaryTables::comment_file_to_enum (1), sub::COMMENT_YES);
+	BOOST_CHECK_EQUAL (sub::STLBinaryTables::comment_enum_to_file (sub::COMMENT_NO), 0);
+	BOOST_CHECK_THROW (sub::STLBinaryTables::comment_file_to_enum (-1), sub::STLError);
+}
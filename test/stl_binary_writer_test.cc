@@ -18,10 +18,18 @@
 */
 
 #include "stl_binary_writer.h"
+#include "stl_binary_reader.h"
+#include "stl_binary_mapped_reader.h"
 #include "subtitle.h"
 #include <boost/test/unit_test.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <fstream>
+#include <vector>
 
 using std::list;
+using std::string;
+using std::vector;
 
 /** Test writing of a binary STL file */
 BOOST_AUTO_TEST_CASE (stl_binary_writer_test)
@@ -117,3 +125,231 @@ BOOST_AUTO_TEST_CASE (stl_binary_writer_test)
 
 }
 
+
+/** Write enough subtitles with STLBinaryWriter that its buffer is written more than once,
+ *  then read them back and check them and the counts in the GSI block.
+ */
+BOOST_AUTO_TEST_CASE (stl_binary_writer_streaming_test)
+{
+	int const N = 2000;
+
+	{
+		sub::STLBinaryWriter writer (
+			"build/test/streaming.stl",
+			25,
+			sub::LANGUAGE_ENGLISH,
+			"Programme", "Episode", "", "", "", "",
+			"190101", "190102", 1, "GBR", "", "", ""
+			);
+
+		for (int i = 0; i < N; ++i) {
+			sub::Subtitle s;
+			s.from = sub::Time::from_hmsf (0, i / 60, i % 60, 0, sub::Rational (25, 1));
+			s.to = sub::Time::from_hmsf (0, i / 60, i % 60, 20, sub::Rational (25, 1));
+			sub::Block b;
+			b.text = string (i % 40, 'x') + "Subtitle " + boost::lexical_cast<string> (i);
+			sub::Line l;
+			l.vertical_position.line = 0;
+			l.vertical_position.lines = 32;
+			l.vertical_position.reference = sub::TOP_OF_SCREEN;
+			l.blocks.push_back (b);
+			s.lines.push_back (l);
+			writer.write (s);
+		}
+
+		writer.close ();
+	}
+
+	std::ifstream in ("build/test/streaming.stl", std::ios::binary);
+	sub::STLBinaryReader reader (in);
+	BOOST_CHECK_EQUAL (reader.tti_blocks, N);
+	BOOST_CHECK_EQUAL (reader.number_of_subtitles, N);
+	/* 39 x's and "Subtitle 1999" */
+	BOOST_CHECK_EQUAL (reader.maximum_characters, 52);
+	BOOST_CHECK_EQUAL (reader.original_programme_title, "Programme                       ");
+
+	list<sub::RawSubtitle> const subs = reader.subtitles ();
+	BOOST_REQUIRE_EQUAL (subs.size(), size_t (N));
+	int n = 0;
+	for (list<sub::RawSubtitle>::const_iterator i = subs.begin(); i != subs.end(); ++i) {
+		BOOST_CHECK_EQUAL (i->text, string (n % 40, 'x') + "Subtitle " + boost::lexical_cast<string> (n));
+		BOOST_CHECK (i->from == sub::Time::from_hmsf (0, n / 60, n % 60, 0, sub::Rational (25, 1)));
+		++n;
+	}
+}
+
+/** Write some subtitles to path, then read them back */
+static sub::STLBinaryReader*
+round_trip (list<sub::Subtitle> const & subs, string path, std::ifstream& in)
+{
+	{
+		sub::STLBinaryWriter writer (
+			path, 25, sub::LANGUAGE_ENGLISH,
+			"", "", "", "", "", "", "190101", "190101", 0, "GBR", "", "", ""
+			);
+		for (list<sub::Subtitle>::const_iterator i = subs.begin(); i != subs.end(); ++i) {
+			writer.write (*i);
+		}
+	}
+
+	in.open (path.c_str(), std::ios::binary);
+	return new sub::STLBinaryReader (in);
+}
+
+static sub::Line
+line (int n)
+{
+	sub::Line l;
+	l.vertical_position.line = n;
+	/* As many lines as STLBinaryWriter uses rows, so that each line gets a row */
+	l.vertical_position.lines = 23;
+	l.vertical_position.reference = sub::TOP_OF_SCREEN;
+	return l;
+}
+
+/** Check that a subtitle too long for one TTI block is split between extension blocks
+ *  without splitting an accented character, and read back in one piece.
+ */
+BOOST_AUTO_TEST_CASE (stl_binary_writer_extension_block_test)
+{
+	list<sub::Subtitle> subs;
+
+	sub::Subtitle s;
+	s.from = sub::Time::from_hmsf (0, 0, 1, 0, sub::Rational (25, 1));
+	s.to = sub::Time::from_hmsf (0, 0, 3, 0, sub::Rational (25, 1));
+	sub::Block b;
+	/* é is 2 bytes in ISO 6937, and these start at the 112th byte of the text */
+	string const text = string (111, 'a') + "é" + string (200, 'b');
+	b.text = text;
+	s.lines.push_back (line (0));
+	s.lines.back().blocks.push_back (b);
+	subs.push_back (s);
+
+	s.from = sub::Time::from_hmsf (0, 0, 4, 0, sub::Rational (25, 1));
+	s.to = sub::Time::from_hmsf (0, 0, 5, 0, sub::Rational (25, 1));
+	s.lines.front().blocks.front().text = "Short";
+	subs.push_back (s);
+
+	std::ifstream in;
+	boost::scoped_ptr<sub::STLBinaryReader> reader (round_trip (subs, "build/test/extension_block.stl", in));
+	/* 111 + 112 + 90 bytes, then one block for the short one */
+	BOOST_CHECK_EQUAL (reader->tti_blocks, 4);
+	BOOST_CHECK_EQUAL (reader->number_of_subtitles, 2);
+
+	list<sub::RawSubtitle> const read = reader->subtitles ();
+	BOOST_REQUIRE_EQUAL (read.size(), 2U);
+	BOOST_CHECK_EQUAL (read.front().text, text);
+	BOOST_CHECK (read.front().from == sub::Time::from_hmsf (0, 0, 1, 0, sub::Rational (25, 1)));
+	BOOST_CHECK (read.front().to == sub::Time::from_hmsf (0, 0, 3, 0, sub::Rational (25, 1)));
+	BOOST_CHECK_EQUAL (read.back().text, "Short");
+
+	/* The first block should end with unused space rather than the first byte of the é */
+	std::ifstream raw ("build/test/extension_block.stl", std::ios::binary);
+	raw.seekg (1024 + 16 + 111);
+	BOOST_CHECK_EQUAL (raw.get(), 0x8f);
+}
+
+/** Check that lines and italics survive being split between extension blocks */
+BOOST_AUTO_TEST_CASE (stl_binary_writer_extension_block_lines_test)
+{
+	sub::Subtitle s;
+	s.from = sub::Time::from_hmsf (0, 0, 1, 0, sub::Rational (25, 1));
+	s.to = sub::Time::from_hmsf (0, 0, 3, 0, sub::Rational (25, 1));
+
+	sub::Block b;
+	b.text = string (90, 'a');
+	s.lines.push_back (line (0));
+	s.lines.back().blocks.push_back (b);
+
+	b.text = string (90, 'b');
+	s.lines.push_back (line (1));
+	s.lines.back().blocks.push_back (b);
+	b.text = "italic";
+	b.italic = true;
+	s.lines.back().blocks.push_back (b);
+
+	b.text = string (90, 'c');
+	b.italic = false;
+	s.lines.push_back (line (2));
+	s.lines.back().blocks.push_back (b);
+
+	std::ifstream in;
+	boost::scoped_ptr<sub::STLBinaryReader> reader (round_trip (list<sub::Subtitle> (1, s), "build/test/extension_block_lines.stl", in));
+	/* 90 + 1 + 90 + 1 + 6 + 1 + 1 + 90 = 280 bytes */
+	BOOST_CHECK_EQUAL (reader->tti_blocks, 3);
+	BOOST_CHECK_EQUAL (reader->number_of_subtitles, 1);
+
+	/* Ignore the empty pieces that STLBinaryReader gives when italics change at the start of a line */
+	vector<sub::RawSubtitle> read;
+	list<sub::RawSubtitle> const all = reader->subtitles ();
+	for (list<sub::RawSubtitle>::const_iterator i = all.begin(); i != all.end(); ++i) {
+		if (!i->text.empty ()) {
+			read.push_back (*i);
+		}
+	}
+
+	BOOST_REQUIRE_EQUAL (read.size(), 4U);
+	BOOST_CHECK_EQUAL (read[0].text, string (90, 'a'));
+	BOOST_CHECK_EQUAL (read[0].vertical_position.line.get(), 0);
+	BOOST_CHECK_EQUAL (read[1].text, string (90, 'b'));
+	BOOST_CHECK_EQUAL (read[1].vertical_position.line.get(), 1);
+	BOOST_CHECK (!read[1].italic);
+	BOOST_CHECK_EQUAL (read[2].text, "italic");
+	BOOST_CHECK_EQUAL (read[2].vertical_position.line.get(), 1);
+	BOOST_CHECK (read[2].italic);
+	BOOST_CHECK_EQUAL (read[3].text, string (90, 'c'));
+	BOOST_CHECK_EQUAL (read[3].vertical_position.line.get(), 2);
+	BOOST_CHECK (!read[3].italic);
+}
+
+/** Check that a subtitle split between extension blocks is read with the timing and
+ *  position of its first block, even if the extension blocks say something else.
+ */
+BOOST_AUTO_TEST_CASE (stl_binary_reader_extension_block_header_test)
+{
+	string const path = "build/test/extension_block_header.stl";
+
+	sub::Subtitle s;
+	s.from = sub::Time::from_hmsf (0, 0, 1, 0, sub::Rational (25, 1));
+	s.to = sub::Time::from_hmsf (0, 0, 3, 0, sub::Rational (25, 1));
+	sub::Block b;
+	b.text = string (200, 'a');
+	s.lines.push_back (line (4));
+	s.lines.back().blocks.push_back (b);
+
+	{
+		sub::STLBinaryWriter writer (
+			path, 25, sub::LANGUAGE_ENGLISH,
+			"", "", "", "", "", "", "190101", "190101", 0, "GBR", "", "", ""
+			);
+		writer.write (s);
+	}
+
+	/* Give the extension block a different time code in, time code out and vertical position */
+	{
+		std::fstream f (path.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+		unsigned char const header[] = { 0, 0, 9, 0, 0, 0, 9, 5, 20 };
+		f.seekp (1024 + 128 + 5);
+		f.write (reinterpret_cast<char const *> (header), sizeof (header));
+	}
+
+	std::ifstream in (path.c_str(), std::ios::binary);
+	sub::STLBinaryReader reader (in);
+	BOOST_REQUIRE_EQUAL (reader.tti_blocks, 2);
+	list<sub::RawSubtitle> const read = reader.subtitles ();
+
+	list<sub::RawSubtitle> mapped_read;
+	sub::STLBinaryMappedReader mapped (path);
+	mapped.subtitles (0, mapped_read);
+
+	BOOST_REQUIRE_EQUAL (read.size(), 1U);
+	BOOST_CHECK_EQUAL (read.front().text, string (200, 'a'));
+	BOOST_CHECK (read.front().from == s.from);
+	BOOST_CHECK (read.front().to == s.to);
+	BOOST_CHECK_EQUAL (read.front().vertical_position.line.get(), 4);
+
+	BOOST_REQUIRE_EQUAL (mapped_read.size(), 1U);
+	BOOST_CHECK (mapped_read.front().from == s.from);
+	BOOST_CHECK (mapped_read.front().to == s.to);
+	BOOST_CHECK_EQUAL (mapped_read.front().vertical_position.line.get(), 4);
+}
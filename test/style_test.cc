@@ -0,0 +1,79 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#include "style.h"
+#include "flat_document.h"
+#include <boost/test/unit_test.hpp>
+#include <list>
+
+using std::list;
+using sub::Style;
+using sub::StyleTable;
+using sub::StyleId;
+
+BOOST_AUTO_TEST_CASE (style_table_test)
+{
+	StyleTable table;
+
+	Style plain;
+	Style italic;
+	italic.italic = true;
+	Style arial;
+	arial.font = "Arial";
+	arial.font_size.set_points (42);
+	Style arial_red = arial;
+	arial_red.colour = sub::Colour (1, 0, 0);
+
+	StyleId const a = table.add (plain);
+	StyleId const b = table.add (italic);
+	StyleId const c = table.add (arial);
+	StyleId const d = table.add (arial_red);
+	BOOST_CHECK_EQUAL (table.size(), 4U);
+	BOOST_CHECK (a != b && a != c && a != d && b != c && b != d && c != d);
+
+	Style arial_again;
+	arial_again.font = "Arial";
+	arial_again.font_size.set_points (42);
+	BOOST_CHECK_EQUAL (table.add (arial_again), c);
+	BOOST_CHECK_EQUAL (table.add (Style ()), a);
+	BOOST_CHECK_EQUAL (table.size(), 4U);
+	BOOST_CHECK (table.get (d) == arial_red);
+}
+
+/** Check that a FlatDocument keeps just one copy of each style */
+BOOST_AUTO_TEST_CASE (flat_document_style_test)
+{
+	list<sub::RawSubtitle> raw;
+	for (int i = 0; i < 1000; ++i) {
+		sub::RawSubtitle r;
+		r.text = "Hello";
+		r.font = "Arial";
+		r.italic = i % 2;
+		r.from = sub::Time::from_frames (i * 10, sub::Rational (25, 1));
+		r.to = sub::Time::from_frames (i * 10 + 5, sub::Rational (25, 1));
+		raw.push_back (r);
+	}
+
+	sub::FlatDocument const doc = sub::collect_flat (raw);
+	BOOST_CHECK_EQUAL (doc.blocks.size(), 1000U);
+	BOOST_CHECK_EQUAL (doc.styles.size(), 2U);
+	BOOST_CHECK (doc.style(doc.blocks[0]).font == std::string ("Arial"));
+	BOOST_CHECK (!doc.style(doc.blocks[0]).italic);
+	BOOST_CHECK (doc.style(doc.blocks[1]).italic);
+}
@@ -374,6 +374,53 @@ BOOST_AUTO_TEST_CASE (subrip_reader_convert_time_test)
 	sub::SubripReader reader;
 	BOOST_CHECK_EQUAL (reader.convert_time ("00:03:10,500"), sub::Time::from_hms (0, 3, 10, 500));
 	BOOST_CHECK_EQUAL (reader.convert_time ("04:19:51,782"), sub::Time::from_hms (4, 19, 51, 782));
+	BOOST_CHECK_EQUAL (reader.convert_time ("+1:-0:2,3"), sub::Time::from_hms (1, 0, 2, 3));
+}
+
+/** @return Error from reading a subtitle with a given from time */
+static std::string
+convert_time_error (std::string t)
+{
+	try {
+		sub::SubripReader reader ("1\n" + t + " --> 00:00:02,000\nHello\n");
+	} catch (sub::SubripError& e) {
+		return e.what ();
+	}
+	return "";
+}
+
+/** Test the errors from SubripReader::convert_time */
+BOOST_AUTO_TEST_CASE (subrip_reader_convert_time_error_test)
+{
+	std::string const format = " when expecting time in the format h:m:s,ms";
+	BOOST_CHECK_EQUAL (convert_time_error (""), "Error in SubRip file: saw an empty string" + format);
+	BOOST_CHECK_EQUAL (convert_time_error ("00:03,500"), "Error in SubRip file: saw 00:03,500" + format);
+	BOOST_CHECK_EQUAL (convert_time_error ("00:00:03:10,500"), "Error in SubRip file: saw 00:00:03:10,500" + format);
+	BOOST_CHECK_EQUAL (convert_time_error ("00:03:10.500"), "Error in SubRip file: saw 00:03:10.500" + format);
+	BOOST_CHECK_EQUAL (convert_time_error ("00:03:10,5,00"), "Error in SubRip file: saw 00:03:10,5,00" + format);
+	BOOST_CHECK_EQUAL (convert_time_error ("0,0:03:10,500"), "Error in SubRip file: saw 0,0:03:10,500 when expecting integer hour value");
+	BOOST_CHECK_EQUAL (convert_time_error ("00::10,500"), "Error in SubRip file: saw 00::10,500 when expecting integer minute value");
+	BOOST_CHECK_EQUAL (convert_time_error ("00:03:1O,500"), "Error in SubRip file: saw 00:03:1O,500 when expecting integer second value");
+	BOOST_CHECK_EQUAL (convert_time_error ("00:03:10,99999999999"), "Error in SubRip file: saw 00:03:10,99999999999 when expecting integer millisecond value");
+}
+
+/** Test that X1/X2/Y1/Y2 coordinates are picked up */
+BOOST_AUTO_TEST_CASE (subrip_reader_coordinates_test)
+{
+	sub::SubripReader reader (
+		"1\n"
+		"00:00:01,000 --> 00:00:02,000 X1:10 X2:200 Y1:30 Y2:400\n"
+		"Hello\n"
+		"\n"
+		"2\n"
+		"00:00:03,000 --> 00:00:04,000\n"
+		"world\n"
+		);
+
+	BOOST_REQUIRE_EQUAL (reader.subtitles().size(), 2U);
+	BOOST_REQUIRE (reader.subtitles().front().subrip_coordinates);
+	BOOST_CHECK (reader.subtitles().front().subrip_coordinates.get() == sub::SubripCoordinates (10, 200, 30, 400));
+	BOOST_CHECK (!reader.subtitles().back().subrip_coordinates);
 }
 
 static void
@@ -563,3 +610,169 @@ BOOST_AUTO_TEST_CASE (subrip_reader_test5)
 	BOOST_CHECK_CLOSE (r._subs.front().colour.g, 2.0 / 255, 0.1);
 	BOOST_CHECK_CLOSE (r._subs.front().colour.b, 3.0 / 255, 0.1);
 }
+
+/** Test nesting of tags, including across lines, and the various ways of giving a <font> colour */
+BOOST_AUTO_TEST_CASE (subrip_reader_tag_nesting_test)
+{
+	sub::SubripReader reader (
+		"1\n"
+		"00:00:01,000 --> 00:00:02,000\n"
+		"<b>a<i>b<b>c</b>d</i>e</b>\n"
+		"<font color=\"Red\">f<FONT COLOR='#00ff00'>g</font>h\n"
+		"</font>i<font face=\"Arial\">j</font><font color=rgb(0,0,255)>k</font>\n"
+		);
+
+	char const * text[] = { "a", "b", "c", "d", "e", "f", "g", "h", "i", "j", "k" };
+	bool const bold[] = { true, true, true, true, true, false, false, false, false, false, false };
+	bool const italic[] = { false, true, true, true, false, false, false, false, false, false, false };
+	sub::Colour const white (1, 1, 1);
+	sub::Colour const red (1, 0, 0);
+	sub::Colour const green (0, 1, 0);
+	sub::Colour const blue (0, 0, 1);
+	sub::Colour const colour[] = { white, white, white, white, white, red, green, red, white, white, blue };
+
+	BOOST_REQUIRE_EQUAL (reader.subtitles().size(), 11U);
+	int n = 0;
+	for (list<sub::RawSubtitle>::const_iterator i = reader.subtitles().begin(); i != reader.subtitles().end(); ++i) {
+		BOOST_CHECK_EQUAL (i->text, text[n]);
+		BOOST_CHECK_EQUAL (i->bold, bold[n]);
+		BOOST_CHECK_EQUAL (i->italic, italic[n]);
+		BOOST_CHECK (i->colour == colour[n]);
+		++n;
+	}
+
+	BOOST_CHECK_THROW (
+		sub::SubripReader ("1\n00:00:01,000 --> 00:00:02,000\n<font color=\"#ff00\">a</font>\n"),
+		sub::SubripError
+		);
+}
+
+/** @return A large SRT with a mix of line endings, tags and blank lines.
+ *  @param error Index of a cue to give a bad time line, or -1.
+ */
+static std::string
+make_big_srt (int cues, int error)
+{
+	std::string srt;
+	for (int i = 0; i < cues; ++i) {
+		char const * eol = (i % 7) ? "\n" : "\r\n";
+		char buffer[256];
+		snprintf (
+			buffer, sizeof(buffer), "%d%s%02d:%02d:%02d,%03d --> %02d:%02d:%02d,%03d%s",
+			i + 1, eol, i / 3600, (i / 60) % 60, i % 60, i % 1000, i / 3600, (i / 60) % 60, i % 60, (i % 1000) + 1,
+			i == error ? " X1:" : eol
+			);
+		srt += buffer;
+		if (i % 5) {
+			snprintf (buffer, sizeof(buffer), "Subtitle <b>%d</b>%s", i, eol);
+		} else {
+			snprintf (buffer, sizeof(buffer), "<i>Subtitle %d%sover two lines</i>%s", i, eol, eol);
+		}
+		srt += buffer;
+		srt += eol;
+		if ((i % 11) == 0) {
+			srt += eol;
+		}
+	}
+	return srt;
+}
+
+/** Test that reading a large SRT with several threads gives the same result as with one */
+BOOST_AUTO_TEST_CASE (subrip_reader_parallel_test)
+{
+	std::string const srt = make_big_srt (100000, -1);
+	sub::SubripReader serial (srt);
+	sub::SubripReader parallel (srt.data(), srt.size(), sub::READ_ALL, 4);
+
+	BOOST_REQUIRE_EQUAL (serial.subtitles().size(), parallel.subtitles().size());
+	list<sub::RawSubtitle>::const_iterator i = serial.subtitles().begin ();
+	list<sub::RawSubtitle>::const_iterator j = parallel.subtitles().begin ();
+	int differences = 0;
+	while (i != serial.subtitles().end()) {
+		if (
+			i->text != j->text || i->from != j->from || i->to != j->to ||
+			i->bold != j->bold || i->italic != j->italic || !(i->vertical_position == j->vertical_position)
+			) {
+			++differences;
+		}
+		++i;
+		++j;
+	}
+	BOOST_CHECK_EQUAL (differences, 0);
+}
+
+/** Test that an error when reading with several threads is reported as it would be with one */
+BOOST_AUTO_TEST_CASE (subrip_reader_parallel_error_test)
+{
+	std::string const srt = make_big_srt (100000, 77777);
+
+	std::string serial_what;
+	list<std::string> serial_context;
+	try {
+		sub::SubripReader serial (srt);
+	} catch (sub::SubripError& e) {
+		serial_what = e.what ();
+		serial_context = e.context ();
+	}
+
+	std::string parallel_what;
+	list<std::string> parallel_context;
+	try {
+		sub::SubripReader parallel (srt.data(), srt.size(), sub::READ_ALL, 4);
+	} catch (sub::SubripError& e) {
+		parallel_what = e.what ();
+		parallel_context = e.context ();
+	}
+
+	BOOST_CHECK (!serial_what.empty ());
+	BOOST_CHECK_EQUAL (serial_what, parallel_what);
+	BOOST_CHECK (serial_context.size() == 7);
+	BOOST_CHECK (serial_context == parallel_context);
+}
+
+/** Test pulling subtitles one at a time from a SubripReader */
+BOOST_AUTO_TEST_CASE (subrip_reader_next_test)
+{
+	FILE* f = fopen ("test/data/test2.srt", "r");
+	BOOST_REQUIRE (f);
+	sub::SubripReader all (f);
+	fclose (f);
+	list<sub::RawSubtitle> subs = all.subtitles ();
+
+	f = fopen ("test/data/test2.srt", "r");
+	BOOST_REQUIRE (f);
+	sub::SubripReader reader (f, sub::READ_ON_DEMAND);
+	BOOST_CHECK (reader.subtitles().empty());
+
+	for (list<sub::RawSubtitle>::const_iterator i = subs.begin(); i != subs.end(); ++i) {
+		boost::optional<sub::RawSubtitle> s = reader.next ();
+		BOOST_REQUIRE (s);
+		BOOST_CHECK_EQUAL (s->text, i->text);
+		BOOST_CHECK_EQUAL (s->from, i->from);
+		BOOST_CHECK_EQUAL (s->to, i->to);
+		BOOST_CHECK_EQUAL (s->bold, i->bold);
+		BOOST_CHECK_EQUAL (s->italic, i->italic);
+		BOOST_CHECK_EQUAL (s->vertical_position.line.get(), i->vertical_position.line.get());
+	}
+
+	BOOST_CHECK (!reader.next ());
+	fclose (f);
+}
+
+/** Test that taking subtitles out of a Reader, and collecting from a range, give the same result as collecting a copy */
+BOOST_AUTO_TEST_CASE (subrip_reader_take_subtitles_test)
+{
+	FILE* f = fopen ("test/data/test.srt", "r");
+	BOOST_REQUIRE (f);
+	sub::SubripReader reader (f);
+	fclose (f);
+
+	list<sub::Subtitle> copied = sub::collect<list<sub::Subtitle> > (reader.subtitles ());
+	list<sub::Subtitle> ranged = sub::collect<list<sub::Subtitle> > (reader.subtitles().begin(), reader.subtitles().end());
+	BOOST_CHECK (copied == ranged);
+
+	vector<sub::Subtitle> taken = sub::collect<vector<sub::Subtitle> > (reader.take_subtitles ());
+	BOOST_CHECK (reader.subtitles().empty());
+	BOOST_REQUIRE_EQUAL (taken.size(), copied.size());
+	BOOST_CHECK (std::equal (copied.begin(), copied.end(), taken.begin()));
+}
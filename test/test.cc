@@ -19,7 +19,6 @@
 
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE libsub_test
-#include "iso6937_tables.h"
 #include "compose.hpp"
 #include <boost/test/unit_test.hpp>
 #include <boost/filesystem.hpp>
@@ -47,8 +46,6 @@ struct TestConfig
 		} else {
 			BOOST_TEST_MESSAGE ("Private data libsub-test-private not found; some tests will not run");
 		}
-
-		sub::make_iso6937_tables ();
 	}
 };
 
@@ -0,0 +1,149 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/** @file  test/time_property_test.cc
+ *  @brief Check that Time arithmetic does not drift over millions of operations.
+ */
+
+#include "sub_time.h"
+#include "random.h"
+#include <boost/test/unit_test.hpp>
+
+using sub::Time;
+using sub::Rational;
+
+static int const rates[] = { 24, 25, 30, 48, 50, 60, 1000 };
+static int const rates_count = sizeof (rates) / sizeof (rates[0]);
+
+/** @return Some time in the first 10 hours at rate */
+static Time
+random_time (Random& random, int rate)
+{
+	return Time::from_frames (random.get (10 * 3600) * rate + random.get (rate), Rational (rate, 1));
+}
+
+/* Adding a frame a million times gives a million frames */
+BOOST_AUTO_TEST_CASE (time_property_accumulate_test)
+{
+	for (int i = 0; i < 2; ++i) {
+		int const rate = i == 0 ? 24 : 25;
+		Time t = Time::from_frames (0, Rational (rate, 1));
+		Time const frame = Time::from_frames (1, Rational (rate, 1));
+		for (int j = 0; j < 1000000; ++j) {
+			t.add (frame);
+		}
+		BOOST_CHECK_EQUAL (t, Time::from_frames (1000000, Rational (rate, 1)));
+	}
+
+	/* 40ms at a time, as frames at 25fps added to a time in milliseconds */
+	Time t = Time::from_hms (0, 0, 0, 0);
+	Time const frame = Time::from_frames (1, Rational (25, 1));
+	for (int j = 0; j < 1000000; ++j) {
+		t.add (frame);
+	}
+	BOOST_CHECK_EQUAL (t, Time::from_hms (0, 0, 40000, 0));
+}
+
+/* Adding and then subtracting the same time at the same rate gets us back to where we were */
+BOOST_AUTO_TEST_CASE (time_property_add_subtract_test)
+{
+	Random random;
+	int failures = 0;
+
+	for (int i = 0; i < 1000000; ++i) {
+		int const rate = rates[random.get (rates_count)];
+		Time const a = random_time (random, rate);
+		Time const b = random_time (random, rate);
+		Time t = a;
+		t.add (b);
+		t.subtract (b);
+		if (t != a) {
+			++failures;
+		}
+	}
+
+	BOOST_CHECK_EQUAL (failures, 0);
+}
+
+/* A retime which is scaled up and then back down again is unchanged */
+BOOST_AUTO_TEST_CASE (time_property_scale_test)
+{
+	Random random;
+	int failures = 0;
+
+	Rational const factors[] = {
+		/* NTSC pull-down */
+		Rational (1001, 1000),
+		/* PAL speed-up */
+		Rational (25, 24),
+		Rational (3, 2),
+	};
+
+	for (int i = 0; i < 1000000; ++i) {
+		int const rate = rates[random.get (rates_count)];
+		Rational const f = factors[random.get (3)];
+		Time const a = random_time (random, rate);
+		Time t = a;
+		t.scale (f);
+		t.scale (Rational (f.denominator, f.numerator));
+		if (t != a) {
+			++failures;
+		}
+	}
+
+	BOOST_CHECK_EQUAL (failures, 0);
+}
+
+/* Converting to a finer rate and back again is lossless */
+BOOST_AUTO_TEST_CASE (time_property_convert_rate_test)
+{
+	Random random;
+	int failures = 0;
+
+	for (int i = 0; i < 1000000; ++i) {
+		int const rate = rates[random.get (rates_count - 1)];
+		Time const a = random_time (random, rate);
+		Time t = a;
+		t.convert_rate (Rational (1000, 1));
+		t.convert_rate (Rational (rate, 1));
+		if (t != a || t.frames_at (Rational (rate, 1)) != a.frames_at (Rational (rate, 1))) {
+			++failures;
+		}
+	}
+
+	BOOST_CHECK_EQUAL (failures, 0);
+}
+
+/* Conversions that are not exact round to the nearest frame */
+BOOST_AUTO_TEST_CASE (time_property_rounding_test)
+{
+	Time t = Time::from_hms (0, 0, 1, 20);
+	t.convert_rate (Rational (25, 1));
+	BOOST_CHECK_EQUAL (t, Time::from_hmsf (0, 0, 1, 1, Rational (25, 1)));
+
+	t = Time::from_hms (0, 0, 1, 19);
+	t.convert_rate (Rational (25, 1));
+	BOOST_CHECK_EQUAL (t, Time::from_hmsf (0, 0, 1, 0, Rational (25, 1)));
+
+	t = Time::from_hms (0, 0, 1, 0);
+	t.subtract (Time::from_hms (0, 0, 2, 500));
+	BOOST_CHECK_EQUAL (t.frames_at (Rational (1000, 1)), 500);
+	BOOST_CHECK (t < Time::from_hms (0, 0, 0, 0));
+	BOOST_CHECK (t == Time::from_hmsf (0, 0, -2, 500, Rational (1000, 1)));
+}
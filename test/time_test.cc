@@ -20,7 +20,9 @@
 #include "sub_time.h"
 #include "exceptions.h"
 #include <boost/test/unit_test.hpp>
+#include <cstdlib>
 #include <iostream>
+#include <vector>
 
 /* Check time construction */
 BOOST_AUTO_TEST_CASE (time_construction_test)
@@ -97,3 +99,53 @@ BOOST_AUTO_TEST_CASE (time_scale_test2)
 	BOOST_CHECK_EQUAL (t.seconds(), 1);
 	BOOST_CHECK_EQUAL (t.frames_at(sub::Rational(1000, 1)), 920);
 }
+
+/* Check that comparisons using ticks give the same answers as comparisons of seconds, frames and rate */
+BOOST_AUTO_TEST_CASE (time_ticks_test)
+{
+	sub::Rational const rates[] = {
+		sub::Rational (1000, 1),
+		sub::Rational (25, 1),
+		sub::Rational (24, 1),
+		sub::Rational (24000, 1001),
+		sub::Rational (48, 1),
+		sub::Rational (250, 1),
+		/* not an exact number of ticks per frame */
+		sub::Rational (1001, 1),
+	};
+
+	int const N = sizeof (rates) / sizeof (rates[0]);
+
+	std::vector<sub::Time> times;
+	srand (1);
+	for (int i = 0; i < 2000; ++i) {
+		sub::Rational const r = rates[rand() % N];
+		int const seconds = rand() % 20;
+		/* Sometimes frames will be more than one second's worth */
+		int const frames = rand() % (r.integer_fraction() + 2);
+		times.push_back (sub::Time::from_hmsf (0, 0, seconds, frames, r));
+	}
+
+	int differences = 0;
+	for (size_t i = 0; i < times.size(); ++i) {
+		for (size_t j = 0; j < times.size(); ++j) {
+			if (
+				(times[i] < times[j]) != sub::less_than_slow (times[i], times[j]) ||
+				(times[i] > times[j]) != sub::greater_than_slow (times[i], times[j]) ||
+				(times[i] == times[j]) != sub::equal_slow (times[i], times[j])
+				) {
+				++differences;
+			}
+		}
+	}
+	BOOST_CHECK_EQUAL (differences, 0);
+
+	/* Times at different rates are compared by what they mean */
+	BOOST_CHECK (sub::Time::from_hmsf (0, 0, 0, 1, sub::Rational (25, 1)) == sub::Time::from_hms (0, 0, 0, 40));
+	BOOST_CHECK (sub::Time::from_hmsf (0, 0, 0, 1001, sub::Rational (1001, 1)) == sub::Time::from_hms (0, 0, 1, 0));
+	BOOST_CHECK (sub::Time::from_hmsf (0, 0, 0, 1, sub::Rational (1001, 1)) < sub::Time::from_hms (0, 0, 0, 1));
+
+	/* Times with no rate are still compared using their frames */
+	BOOST_CHECK (sub::Time::from_hmsf (0, 0, 1, 4) < sub::Time::from_hmsf (0, 0, 1, 5));
+	BOOST_CHECK_THROW (sub::Time::from_hmsf (0, 0, 1, 4) < sub::Time::from_hms (0, 0, 1, 4), sub::UnknownFrameRateError);
+}
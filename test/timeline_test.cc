@@ -0,0 +1,95 @@
+/*
+    Copyright (C) 2019 Carl Hetherington <cth@carlh.net>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#include "timeline.h"
+#include "raw_subtitle.h"
+#include "random_subtitles.h"
+#include <boost/test/unit_test.hpp>
+#include <list>
+#include <vector>
+
+using std::list;
+using std::vector;
+using sub::RawSubtitle;
+using sub::Time;
+using sub::Rational;
+using sub::Timeline;
+
+static Time
+frame (int f)
+{
+	return Time::from_frames (f, Rational (25, 1));
+}
+
+/** @return Subtitles of various lengths, in no particular order, which overlap each other a lot */
+static vector<RawSubtitle>
+make_subtitles ()
+{
+	return make_random_subtitles (1, 2000, Rational (25, 1), 10000, 20, 500);
+}
+
+BOOST_AUTO_TEST_CASE (timeline_test)
+{
+	vector<RawSubtitle> const subs = make_subtitles ();
+	Timeline const timeline (subs);
+	BOOST_CHECK_EQUAL (timeline.size(), subs.size());
+
+	vector<size_t> found;
+	for (int f = -5; f < 10600; f += 37) {
+		timeline.at (frame (f), found);
+		BOOST_CHECK (found == brute_force (subs, OnScreenAt (frame (f))));
+		timeline.during (frame (f), frame (f + 50), found);
+		BOOST_CHECK (found == brute_force (subs, OnScreenDuring (frame (f), frame (f + 50))));
+	}
+
+	/* A Timeline can be made from a list too */
+	list<RawSubtitle> const subs_list (subs.begin(), subs.end());
+	Timeline const list_timeline (subs_list);
+	list_timeline.at (frame (5000), found);
+	BOOST_CHECK (found == brute_force (subs, OnScreenAt (frame (5000))));
+}
+
+/** Check that a Cursor agrees with Timeline::at() going forwards one frame at a time,
+ *  forwards in jumps, and backwards.
+ */
+BOOST_AUTO_TEST_CASE (timeline_cursor_test)
+{
+	vector<RawSubtitle> const subs = make_subtitles ();
+	Timeline const timeline (subs);
+	Timeline::Cursor cursor (timeline);
+
+	vector<size_t> expected;
+	int differences = 0;
+	for (int f = 0; f < 10600; ++f) {
+		timeline.at (frame (f), expected);
+		if (cursor.at (frame (f)) != expected) {
+			++differences;
+		}
+	}
+
+	int const jumps[] = { 3, 1000, 1001, 9000, 200, 200, 5000, 5500, 0, 10600 };
+	for (size_t i = 0; i < sizeof (jumps) / sizeof (jumps[0]); ++i) {
+		timeline.at (frame (jumps[i]), expected);
+		if (cursor.at (frame (jumps[i])) != expected) {
+			++differences;
+		}
+	}
+
+	BOOST_CHECK_EQUAL (differences, 0);
+}
@@ -19,7 +19,7 @@
 
 #include "reader_factory.h"
 #include "reader.h"
-#include "collect.h"
+#include "flat_document.h"
 #include <getopt.h>
 #include <boost/filesystem.hpp>
 #include <map>
@@ -29,7 +29,7 @@ using std::string;
 using std::cerr;
 using std::cout;
 using std::map;
-using std::list;
+using std::vector;
 using boost::shared_ptr;
 using namespace sub;
 
@@ -83,11 +83,12 @@ main (int argc, char* argv[])
 		cout << i->first << ": " << i->second << "\n";
 	}
 
-	list<sub::Subtitle> subs = collect<list<sub::Subtitle> > (reader->subtitles ());
+	FlatDocument const doc = collect_flat (reader->subtitles ());
 	int n = 0;
-	for (list<sub::Subtitle>::const_iterator i = subs.begin(); i != subs.end(); ++i) {
+	for (vector<FlatSubtitle>::const_iterator i = doc.subtitles.begin(); i != doc.subtitles.end(); ++i) {
 		cout << "Subtitle " << n << " at " << i->from << " -> " << i->to << "\n";
-		for (list<sub::Line>::const_iterator j = i->lines.begin(); j != i->lines.end(); ++j) {
+		vector<FlatLine>::const_iterator const lines_begin = doc.lines.begin() + i->first_line;
+		for (vector<FlatLine>::const_iterator j = lines_begin; j != lines_begin + i->line_count; ++j) {
 
 			cout << "\t";
 
@@ -117,22 +118,24 @@ main (int argc, char* argv[])
 			cout << "\t";
 			bool italic = false;
 			bool underline = false;
-			for (list<sub::Block>::const_iterator k = j->blocks.begin(); k != j->blocks.end(); ++k) {
-				if (k->italic && !italic) {
+			vector<FlatBlock>::const_iterator const blocks_begin = doc.blocks.begin() + j->first_block;
+			for (vector<FlatBlock>::const_iterator k = blocks_begin; k != blocks_begin + j->block_count; ++k) {
+				Style const & style = doc.style (*k);
+				if (style.italic && !italic) {
 					cout << "<i>";
-				} else if (italic && !k->italic) {
+				} else if (italic && !style.italic) {
 					cout << "</i>";
 				}
-				if (k->underline && !underline) {
+				if (style.underline && !underline) {
 					cout << "<u>";
-				} else if (underline && !k->underline) {
+				} else if (underline && !style.underline) {
 					cout << "</u>";
 				}
 
-				italic = k->italic;
-				underline = k->underline;
+				italic = style.italic;
+				underline = style.underline;
 
-				cout << k->text;
+				cout.write (k->text, k->text_size);
 			}
 
 			if (italic) {